@@ -0,0 +1,406 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+
+#include "bitboard.h"
+#include "common.h"
+#include "engine.h"
+#include "rng.h"
+#include "timing.h"
+#include "agentA.h"
+#include "agentB.h"
+#include "mnk.h"
+#include "batch.h"
+#include "arena.h"
+#include "tree.h"
+#include "ucb.h"
+#include "policy.h"
+#include "parallel.h"
+
+/*
+ * Times the search kernels one at a time, then whole moves on fixed
+ * positions. Every benchmark is repeated and reported as one record with
+ * the mean, standard deviation and minimum time per operation, as JSON
+ * lines (default) or CSV, so two builds can be compared line by line.
+ */
+
+#ifndef BENCH_BUILD_TYPE
+#define BENCH_BUILD_TYPE ""
+#endif
+
+#define BENCH_POSITIONS 64 /* Boards cycled through by the winner checks */
+#define MAX_REPS 1000
+
+typedef struct {
+    const char* name;
+    const char* cells; /* Nine of ' ', 'X', 'O', row by row */
+    char toMove;
+} BenchPosition;
+
+static const BenchPosition positions[] = {
+    { "empty",    "         ", 'X' },
+    { "opening",  "    X   O", 'X' },
+    { "midgame",  "X O  X  O", 'X' },
+    { "tactical", "XO  X  O ", 'O' }, /* O must block the diagonal */
+};
+#define NUM_POSITIONS (int)(sizeof(positions) / sizeof(positions[0]))
+
+/* One output record; fields that do not apply stay zero */
+typedef struct {
+    const char* name;
+    const char* position;
+    int reps;
+    long ops;           /* Operations per repetition */
+    double samples[MAX_REPS]; /* Nanoseconds per operation */
+    double nodes;
+    double bytes;
+} Record;
+
+typedef int (*KernelFn)(const GameState* state, int count);
+
+static int csvOutput = 0;
+static volatile int sink; /* Keeps checksums, and the work behind them, alive */
+
+static void toGameState(const BenchPosition* position, GameState* state) {
+    for (int i = 0; i < BB_CELLS; i++)
+        state->cells[i / 3][i % 3] = position->cells[i];
+    state->toMove = position->toMove;
+}
+
+static void printRecord(const Record* record) {
+    double mean = 0, variance = 0, best = record->samples[0];
+    for (int i = 0; i < record->reps; i++) {
+        mean += record->samples[i];
+        if (record->samples[i] < best)
+            best = record->samples[i];
+    }
+    mean /= record->reps;
+    for (int i = 0; i < record->reps; i++)
+        variance += (record->samples[i] - mean) * (record->samples[i] - mean);
+    variance = record->reps > 1 ? variance / (record->reps - 1) : 0;
+    double opsPerSec = mean > 0 ? 1e9 / mean : 0;
+
+    if (csvOutput) {
+        printf("%s,%s,%d,%ld,%.2f,%.2f,%.2f,%.0f,%.0f,%.0f\n", record->name, record->position,
+               record->reps, record->ops, mean, sqrt(variance), best, opsPerSec,
+               record->nodes, record->bytes);
+    } else {
+        printf("{\"name\":\"%s\",\"position\":\"%s\",\"reps\":%d,\"ops\":%ld,"
+               "\"mean_ns\":%.2f,\"stddev_ns\":%.2f,\"min_ns\":%.2f,\"ops_per_sec\":%.0f,"
+               "\"nodes\":%.0f,\"bytes\":%.0f}\n", record->name, record->position,
+               record->reps, record->ops, mean, sqrt(variance), best, opsPerSec,
+               record->nodes, record->bytes);
+    }
+    fflush(stdout);
+}
+
+/* Boards from random games, stopped after a random number of moves */
+static void makeBoards(BitBoard boards[BENCH_POSITIONS]) {
+    Rng rng;
+    rngInit(&rng, 42);
+    for (int i = 0; i < BENCH_POSITIONS; i++) {
+        BitBoard bb = { 0, 0, 'X' };
+        int moves = rngBelow(&rng, BB_CELLS + 1);
+        while (moves-- > 0 && !bbIsTerminal(&bb)) {
+            unsigned empty = bbEmpty(&bb);
+            bbPlay(&bb, bbNth(empty, rngBelow(&rng, bbCount(empty))));
+        }
+        boards[i] = bb;
+    }
+}
+
+static void benchWinner(int reps, long ops) {
+    BitBoard boards[BENCH_POSITIONS];
+    char grids[BENCH_POSITIONS][3][3];
+    makeBoards(boards);
+    for (int i = 0; i < BENCH_POSITIONS; i++)
+        bbToBoard(&boards[i], grids[i]);
+
+    Record record = { .name = "winner_bitboard", .position = "random", .reps = reps, .ops = ops };
+    for (int r = 0; r < reps; r++) {
+        int checksum = 0;
+        double start = timeNowMs();
+        for (long i = 0; i < ops; i++)
+            checksum += bbWinner(&boards[i & (BENCH_POSITIONS - 1)]);
+        record.samples[r] = (timeNowMs() - start) * 1e6 / ops;
+        sink += checksum;
+    }
+    printRecord(&record);
+
+    /* The board-based check used by the game loop */
+    Record boardRecord = { .name = "winner_board", .position = "random", .reps = reps, .ops = ops };
+    for (int r = 0; r < reps; r++) {
+        int checksum = 0;
+        double start = timeNowMs();
+        for (long i = 0; i < ops; i++) {
+            memcpy(board, grids[i & (BENCH_POSITIONS - 1)], sizeof(board));
+            checksum += checkWinner();
+        }
+        boardRecord.samples[r] = (timeNowMs() - start) * 1e6 / ops;
+        sink += checksum;
+    }
+    printRecord(&boardRecord);
+}
+
+static void benchKernel(const char* name, KernelFn kernel, int reps, long ops) {
+    for (int p = 0; p < NUM_POSITIONS; p++) {
+        GameState state;
+        toGameState(&positions[p], &state);
+        Record record = { .name = name, .position = positions[p].name, .reps = reps, .ops = ops };
+        for (int r = 0; r < reps; r++) {
+            double start = timeNowMs();
+            sink += kernel(&state, (int)ops);
+            record.samples[r] = (timeNowMs() - start) * 1e6 / ops;
+        }
+        printRecord(&record);
+    }
+}
+
+/* Batched random playouts with each kernel the CPU supports; ops is games */
+static void benchBatch(int reps, long ops) {
+    static const int kernels[] = { BATCH_SCALAR, BATCH_AVX2 };
+    static const char* names[] = { "batch_scalar", "batch_avx2" };
+    for (int p = 0; p < NUM_POSITIONS; p++) {
+        GameState state;
+        toGameState(&positions[p], &state);
+        BitBoard start = bbFromBoard(state.cells, state.toMove);
+        for (int k = 0; k < (int)(sizeof(kernels) / sizeof(kernels[0])); k++) {
+            if (!batchAvailable(kernels[k]))
+                continue;
+            Record record = { .name = names[k], .position = positions[p].name, .reps = reps, .ops = ops };
+            for (int r = 0; r < reps; r++) {
+                BatchRng rng;
+                batchRngInit(&rng, (uint64_t)r + 1);
+                double begin = timeNowMs();
+                int halfWins = batchPlayouts(kernels[k], &start, (int)ops, &rng, start.toMove);
+                record.samples[r] = (timeNowMs() - begin) * 1e6 / ops;
+                sink += halfWins;
+            }
+            printRecord(&record);
+        }
+    }
+}
+
+/* Whole searches with a fixed budget; ops is the iterations per move */
+static void benchMoves(char agent, const char* name, int reps, int iterations) {
+    SearchConfig config;
+    memset(&config, 0, sizeof(config));
+    config.iterations = iterations;
+    config.exhaustive = 1; /* Same work on every repetition */
+    config.threads = 1;
+
+    for (int p = 0; p < NUM_POSITIONS; p++) {
+        GameState state;
+        toGameState(&positions[p], &state);
+        Record record = { .name = name, .position = positions[p].name, .reps = reps, .ops = iterations };
+        for (int r = 0; r < reps; r++) {
+            /* A fresh engine each time, so no tree is carried over */
+            Engine* engine = engineCreate();
+            SearchResult result;
+            config.seed = (uint64_t)r + 1;
+            engineSearch(engine, agent, &state, &config, &result);
+            record.samples[r] = result.elapsedMs * 1e6 / (result.iterations > 0 ? result.iterations : 1);
+            record.nodes += result.nodes / (double)reps;
+            record.bytes += result.nodeBytes / (double)reps;
+            engineDestroy(engine);
+        }
+        printRecord(&record);
+    }
+}
+
+/* Whole searches on the empty m,n,k boards */
+static void benchMnkMoves(char agent, const char* name, int reps, int iterations) {
+    static const int sizes[][3] = { { 7, 7, 4 }, { 15, 15, 5 } };
+    SearchConfig config;
+    memset(&config, 0, sizeof(config));
+    config.iterations = iterations;
+    config.exhaustive = 1;
+
+    for (int s = 0; s < (int)(sizeof(sizes) / sizeof(sizes[0])); s++) {
+        char label[32];
+        snprintf(label, sizeof(label), "%dx%dx%d", sizes[s][0], sizes[s][1], sizes[s][2]);
+        MnkState state;
+        mnkInit(&state, sizes[s][0], sizes[s][1], sizes[s][2]);
+        Record record = { .name = name, .position = label, .reps = reps, .ops = iterations };
+        Engine* engine = engineCreate();
+        for (int r = 0; r < reps; r++) {
+            SearchResult result;
+            config.seed = (uint64_t)r + 1;
+            engineSearchMnk(engine, agent, &state, &config, &result);
+            record.samples[r] = result.elapsedMs * 1e6 / (result.iterations > 0 ? result.iterations : 1);
+            record.nodes += result.nodes / (double)reps;
+            record.bytes += result.nodeBytes / (double)reps;
+        }
+        engineDestroy(engine);
+        printRecord(&record);
+    }
+}
+
+/* Random child blocks with ties, unvisited and proven children, each in its own node */
+#define UCB_CASES 256 /* Few enough to stay in cache */
+static void makeUcbCases(Tree* tree, TreeNode nodes[UCB_CASES], int counts[UCB_CASES],
+                         int parents[UCB_CASES]) {
+    Rng rng;
+    rngInit(&rng, 7);
+    for (int c = 0; c < UCB_CASES; c++) {
+        int count = 1 + rngBelow(&rng, BB_CELLS);
+        Children children = treeAllocChildren(tree, &nodes[c], count);
+        int parent = 0;
+        for (int i = 0; i < count; i++) {
+            /* Small counts make exact ties between children common */
+            int visits = rngBelow(&rng, 4) == 0 ? rngBelow(&rng, 3) : rngBelow(&rng, 5000);
+            atomic_init(&children.visits[i], visits);
+            atomic_init(&children.halfWins[i], (int)rngBelow(&rng, 2 * visits + 1));
+            atomic_init(&children.inFlight[i], rngBelow(&rng, 8) == 0 ? (int)rngBelow(&rng, 3) : 0);
+            atomic_init(&children.proven[i], rngBelow(&rng, 8) == 0 ? "XOD"[rngBelow(&rng, 3)] : ' ');
+            parent += visits;
+        }
+        counts[c] = count;
+        parents[c] = parent + (int)rngBelow(&rng, 3);
+    }
+}
+
+/* The UCB kernel against the reference loop on the same cases; ops is selections */
+static void benchUcb(int reps, long ops) {
+    static const UcbRule rules[] = { UCB_RULE_A, UCB_RULE_B };
+    static const char* ruleNames[] = { "rule_a", "rule_b" };
+    static const double constants[] = { UCB_EXPLORATION_A, UCB_EXPLORATION_B };
+    static TreeNode nodes[UCB_CASES];
+    static int counts[UCB_CASES], parents[UCB_CASES];
+    Arena arena = { 0 };
+    Tree tree;
+    treeInit(&tree, &arena, NULL, NULL);
+    makeUcbCases(&tree, nodes, counts, parents);
+
+    for (int r = 0; r < 2; r++) {
+        Record reference = { .name = "ucb_reference", .position = ruleNames[r], .reps = reps, .ops = ops };
+        Record kernel = { .name = "ucb_kernel", .position = ruleNames[r], .reps = reps, .ops = ops };
+        for (int rep = 0; rep < reps; rep++) {
+            for (int which = 0; which < 2; which++) {
+                int checksum = 0;
+                double start = timeNowMs();
+                for (long i = 0; i < ops; i++) {
+                    int c = (int)(i & (UCB_CASES - 1));
+                    Children children = treeChildren(&nodes[c], counts[c]);
+                    checksum += which == 0 ?
+                        ucbSelectReference(&children, counts[c], parents[c], constants[r], rules[r]) :
+                        ucbSelect(&children, counts[c], parents[c], constants[r], rules[r]);
+                }
+                (which == 0 ? &reference : &kernel)->samples[rep] = (timeNowMs() - start) * 1e6 / ops;
+                sink += checksum;
+            }
+        }
+        printRecord(&reference);
+        printRecord(&kernel);
+    }
+    arenaDestroy(&arena);
+}
+
+/* Agent A's playout policy: the table against the scan it is built from; ops is moves */
+static void benchPolicy(int reps, long ops) {
+    const unsigned char* table = policyTable();
+    BitBoard boards[BENCH_POSITIONS];
+    makeBoards(boards);
+    for (int i = 0; i < BENCH_POSITIONS; i++) {
+        /* Finished boards are swapped for the empty one */
+        if (bbIsTerminal(&boards[i]))
+            boards[i] = (BitBoard){ 0, 0, 'X' };
+    }
+    Record heuristic = { .name = "policy_heuristic", .position = "random", .reps = reps, .ops = ops };
+    Record lookup = { .name = "policy_table", .position = "random", .reps = reps, .ops = ops };
+    for (int r = 0; r < reps; r++) {
+        for (int which = 0; which < 2; which++) {
+            int checksum = 0;
+            double start = timeNowMs();
+            for (long i = 0; i < ops; i++) {
+                const BitBoard* bb = &boards[i & (BENCH_POSITIONS - 1)];
+                checksum += which == 0 ? policyHeuristicMove(bb) : policyMove(table, bb);
+            }
+            (which == 0 ? &heuristic : &lookup)->samples[r] = (timeNowMs() - start) * 1e6 / ops;
+            sink += checksum;
+        }
+    }
+    printRecord(&heuristic);
+    printRecord(&lookup);
+}
+
+#define SCHEDULER_THREADS 4
+
+/* Work growing with the task number, so the first shares finish early and must steal */
+static void schedulerTask(void* context, int task, int worker) {
+    int* checksum = (int*)context;
+    int sum = 0;
+    for (int i = 0; i < task % 256; i++)
+        sum += i * task;
+    checksum[worker] += sum;
+}
+
+/* parallelFor() on uneven tasks; ops is tasks */
+static void benchScheduler(int reps, long ops) {
+    int checksum[SCHEDULER_THREADS];
+    Record record = { .name = "parallel_for", .position = "uneven", .reps = reps, .ops = ops };
+    for (int r = 0; r < reps; r++) {
+        memset(checksum, 0, sizeof(checksum));
+        double start = timeNowMs();
+        parallelFor(schedulerTask, checksum, (int)ops, SCHEDULER_THREADS);
+        record.samples[r] = (timeNowMs() - start) * 1e6 / ops;
+        for (int w = 0; w < SCHEDULER_THREADS; w++)
+            sink += checksum[w];
+    }
+    printRecord(&record);
+}
+
+static void usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -r, --reps N    repetitions of every benchmark (default 10)\n");
+    printf("  -q, --quick     a tenth of the work per repetition\n");
+    printf("  -c, --csv       CSV instead of JSON lines\n");
+}
+
+int main(int argc, char* argv[]) {
+    int reps = 10;
+    long scale = 10;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--reps") == 0) && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+            if (reps < 1)
+                reps = 1;
+            if (reps > MAX_REPS)
+                reps = MAX_REPS;
+        } else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quick") == 0) {
+            scale = 1;
+        } else if (strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--csv") == 0) {
+            csvOutput = 1;
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (csvOutput) {
+        printf("# build=%s batch=%s\n", BENCH_BUILD_TYPE, batchKernelName());
+        printf("name,position,reps,ops,mean_ns,stddev_ns,min_ns,ops_per_sec,nodes,bytes\n");
+    } else {
+        printf("{\"build\":\"%s\",\"batch\":\"%s\",\"reps\":%d}\n", BENCH_BUILD_TYPE,
+               batchKernelName(), reps);
+    }
+
+    benchWinner(reps, 1000000 * scale);
+    benchPolicy(reps, 1000000 * scale);
+    benchKernel("playout_a", agentA_benchPlayouts, reps, 20000 * scale);
+    benchKernel("playout_b", agentB_benchPlayouts, reps, 20000 * scale);
+    benchBatch(reps, 20000 * scale);
+    benchKernel("select_a", agentA_benchSelect, reps, 100000 * scale);
+    benchKernel("select_b", agentB_benchSelect, reps, 100000 * scale);
+    benchUcb(reps, 100000 * scale);
+    benchScheduler(reps, 10000 * scale);
+    benchKernel("nodes_a", agentA_benchNodes, reps, 10000 * scale);
+    benchKernel("nodes_b", agentB_benchNodes, reps, 10000 * scale);
+    benchMoves('a', "move_a", reps, 500 * (int)scale);
+    benchMoves('b', "move_b", reps, 500 * (int)scale);
+    benchMnkMoves('a', "move_mnk_a", reps, 200 * (int)scale);
+    benchMnkMoves('b', "move_mnk_b", reps, 200 * (int)scale);
+    return 0;
+}
@@ -1,301 +1,112 @@
 #include <stdlib.h>
 #include <stdio.h>
-#include <math.h>
 #include <string.h>
-#include <float.h>
+#include <math.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "common.h"
+#include "bitboard.h"
+#include "arena.h"
+#include "ttable.h"
+#include "tree.h"
+#include "parallel.h"
+#include "rng.h"
+#include "timing.h"
+#include "anytime.h"
+#include "playout.h"
+#include "policy.h"
+#include "solver.h"
+#include "symmetry.h"
+#include "ucb.h"
 #include "agentA.h"
 
-/* Define constants for MCTS */
-#define SIMULATION_ITERATIONS 5000
-#define UCB1_CONST 0.7 /* Adjusted value */
-
-/* Node structure for MCTS */
-typedef struct Node {
-    char state[3][3];
-    int player; /* 'X' or 'O' */
-    int move_row;
-    int move_col;
-    int visits;
-    double wins;
-    struct Node* parent;
-    struct Node* children[9];
-    int child_count;
-} Node;
-
-/* Function prototypes */
-static Node* createNode(char state[3][3], int player, int move_row, int move_col, Node* parent);
-static void addChild(Node* parent, Node* child);
-static Node* selectBestChild(Node* node);
-static void expandNode(Node* node);
-static char simulatePlayout(Node* node);
-static void backpropagate(Node* node, char result, char agentPlayer);
-static int isTerminalState(char state[3][3]);
-static int checkWinnerState(char state[3][3]);
-static void copyState(char dest[3][3], char src[3][3]);
-static void freeTree(Node* node);
-static void selectRandomMove(char state[3][3], int *row, int *col);
-
-/* Add these function prototypes */
-static int findWinningMove(char state[3][3], char player, int *row, int *col);
-static int findBlockingMove(char state[3][3], char player, int *row, int *col);
-
-void agentA_move(char player) {
-    char opponent = (player == 'X') ? 'O' : 'X';
-    Node* root = createNode(board, opponent, -1, -1, NULL);
-
-    for (int i = 0; i < SIMULATION_ITERATIONS; i++) {
-        Node* promisingNode = root;
-
-        /* Selection */
-        while (promisingNode->child_count > 0) {
-            promisingNode = selectBestChild(promisingNode);
-        }
-
-        /* Expansion */
-        if (!isTerminalState(promisingNode->state)) {
-            expandNode(promisingNode);
-            if (promisingNode->child_count > 0) {
-                promisingNode = promisingNode->children[rand() % promisingNode->child_count];
-            }
-        }
-
-        /* Simulation */
-        char playoutResult = simulatePlayout(promisingNode);
-
-        /* Backpropagation */
-        backpropagate(promisingNode, playoutResult, player);
-    }
-
-    /* Choosing the best move */
-    Node* bestChild = NULL;
-    double bestWinRate = -1.0;
-    for (int i = 0; i < root->child_count; i++) {
-        Node* child = root->children[i];
-        double winRate = (double)child->wins / (double)child->visits;
-        if (winRate > bestWinRate) {
-            bestWinRate = winRate;
-            bestChild = child;
-        }
-    }
-
-    if (suppressMessages == 0) {
-        printf("Agent A is considering %d possible moves.\n", root->child_count);
-        if (bestChild) {
-            printf("Agent A selects move at row %d, column %d with win rate %.2f%%.\n",
-                bestChild->move_row, bestChild->move_col, bestWinRate * 100);
-        } else {
-            printf("Agent A failed to select a best move, choosing randomly.\n");
-        }
-    }
-
-    if (bestChild) {
-        board[bestChild->move_row][bestChild->move_col] = player;
-    } else {
-        /* Fallback to random move */
-        int i, j;
-        do {
-            i = rand() % 3;
-            j = rand() % 3;
-        } while (board[i][j] != ' ');
-        board[i][j] = player;
-    }
-
-    /* Free memory */
-    freeTree(root);
+/* Agent A's policies for the MCTS core in mcts_impl.h */
+#define MCTS_AGENT AgentA
+#define MCTS_LABEL "A"
+#define MCTS_UCB_RULE UCB_RULE_A
+#define MCTS_EXPLORATION UCB_EXPLORATION_A
+#define MCTS_REUSE_TREE 1
+#define MCTS_ROOT_MOVER(player) (player)
+#define MCTS_DESCEND_ON_EXPAND 1
+/* An unvisited move is never chosen over one with a record, unless it is proven */
+#define MCTS_UNVISITED_RATE(proven, player) ((proven) != ' ' ? solverWinRate(proven, player) : NAN)
+
+/* The heuristic playout is deterministic; all it needs is the policy table */
+typedef const unsigned char* Rollout;
+
+static char simulatePlayout(const BitBoard* state, const unsigned char* policy);
+
+static int rolloutBatch(const SearchConfig* config) {
+    (void)config;
+    return 1;
 }
 
-/* Function implementations */
-
-static Node* createNode(char state[3][3], int player, int move_row, int move_col, Node* parent) {
-    Node* node = (Node*)malloc(sizeof(Node));
-    copyState(node->state, state);
-    node->player = player;
-    node->move_row = move_row;
-    node->move_col = move_col;
-    node->visits = 0;
-    node->wins = 0.0;
-    node->parent = parent;
-    node->child_count = 0;
-    return node;
+static void rolloutInit(Rollout* rollout, const SearchConfig* config, Rng* rng) {
+    (void)config;
+    (void)rng;
+    *rollout = policyTable();
 }
 
-static void addChild(Node* parent, Node* child) {
-    parent->children[parent->child_count++] = child;
+static int rolloutHalfWins(Rollout* rollout, Rng* rng, const BitBoard* state, int playouts,
+                           char player) {
+    (void)rng;
+    return playouts * solverHalfWins(simulatePlayout(state, *rollout), player);
 }
 
-static Node* selectBestChild(Node* node) {
-    Node* bestChild = NULL;
-    double bestValue = -DBL_MAX;
-    for (int i = 0; i < node->child_count; i++) {
-        Node* child = node->children[i];
-
-        /* If the child has not been visited yet, prioritize it */
-        if (child->visits == 0) {
-            return child;
-        }
+#include "mcts_impl.h"
 
-        double winRate = (double)child->wins / (double)child->visits;
-        double ucbValue = winRate +
-            UCB1_CONST * sqrt(log((double)node->visits) / (double)child->visits);
-
-        if (ucbValue > bestValue) {
-            bestValue = ucbValue;
-            bestChild = child;
-        }
-    }
-    return bestChild;
+AgentA* agentA_create(void) {
+    return mctsCreate();
 }
 
-static void expandNode(Node* node) {
-    char nextPlayer = (node->player == 'X') ? 'O' : 'X';
-
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            if (node->state[i][j] == ' ') {
-                char newState[3][3];
-                copyState(newState, node->state);
-                newState[i][j] = nextPlayer;
-                Node* child = createNode(newState, nextPlayer, i, j, node);
-                addChild(node, child);
-            }
-        }
-    }
+void agentA_destroy(AgentA* agent) {
+    mctsDestroy(agent);
 }
 
-static char simulatePlayout(Node* node) {
-    char simState[3][3];
-    copyState(simState, node->state);
-    char currentPlayer = (node->player == 'X') ? 'O' : 'X';
-    char winner;
-    while ((winner = checkWinnerState(simState)) == ' ') {
-        int moveRow, moveCol;
-        if (findWinningMove(simState, currentPlayer, &moveRow, &moveCol)) {
-            simState[moveRow][moveCol] = currentPlayer;
-        } else if (findBlockingMove(simState, currentPlayer, &moveRow, &moveCol)) {
-            simState[moveRow][moveCol] = currentPlayer;
-        } else {
-            selectRandomMove(simState, &moveRow, &moveCol);
-            simState[moveRow][moveCol] = currentPlayer;
-        }
-        currentPlayer = (currentPlayer == 'X') ? 'O' : 'X';
-    }
-    return winner;
+void agentA_reset(AgentA* agent) {
+    agent->treeMover = ' ';
 }
 
-static void backpropagate(Node* node, char result, char agentPlayer) {
-    Node* currentNode = node;
-    while (currentNode != NULL) {
-        currentNode->visits++;
-
-        if (result == agentPlayer) {
-            currentNode->wins += 1.0;
-        } else if (result == 'D') {
-            currentNode->wins += 0.5;
-        } else {
-            /* currentNode->wins += 0.0; */
-        }
-
-        currentNode = currentNode->parent;
-    }
+int agentA_search(AgentA* agent, const GameState* state, const SearchConfig* config,
+                  SearchResult* result) {
+    return mctsSearch(agent, state, config, result);
 }
 
-static int isTerminalState(char state[3][3]) {
-    return checkWinnerState(state) != ' ';
+void agentA_move(char player) {
+    move('a', player);
 }
 
-static int checkWinnerState(char state[3][3]) {
-    /* Similar to checkWinner() but operates on a given state */
-    /* Check rows and columns */
-    for (int i = 0; i < 3; i++) {
-        if (state[i][0] == state[i][1] && state[i][1] == state[i][2] && state[i][0] != ' ')
-            return state[i][0];
-        if (state[0][i] == state[1][i] && state[1][i] == state[2][i] && state[0][i] != ' ')
-            return state[0][i];
-    }
-    /* Check diagonals */
-    if (state[0][0] == state[1][1] && state[1][1] == state[2][2] && state[0][0] != ' ')
-        return state[0][0];
-    if (state[0][2] == state[1][1] && state[1][1] == state[2][0] && state[0][2] != ' ')
-        return state[0][2];
-    /* Check for draw or ongoing game */
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            if (state[i][j] == ' ')
-                return ' '; /* Game is ongoing */
-        }
-    }
-    return 'D'; /* Draw */
+int agentA_benchPlayouts(const GameState* state, int count) {
+    BitBoard position = rootPosition(state);
+    /* The playout is deterministic; volatile keeps it from being hoisted out of the loop */
+    const BitBoard* volatile start = &position;
+    const unsigned char* policy = policyTable();
+    int checksum = 0;
+    for (int i = 0; i < count; i++)
+        checksum += simulatePlayout(start, policy);
+    return checksum;
 }
 
-static void copyState(char dest[3][3], char src[3][3]) {
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            dest[i][j] = src[i][j];
-        }
-    }
+int agentA_benchSelect(const GameState* state, int count) {
+    return mctsBenchSelect(state, count);
 }
 
-static void freeTree(Node* node) {
-    for (int i = 0; i < node->child_count; i++) {
-        freeTree(node->children[i]);
-    }
-    free(node);
+int agentA_benchNodes(const GameState* state, int count) {
+    return mctsBenchNodes(state, count);
 }
 
-static int findWinningMove(char state[3][3], char player, int *row, int *col) {
-    // Check all empty positions to see if placing a mark there wins the game
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            if (state[i][j] == ' ') {
-                state[i][j] = player;
-                if (checkWinnerState(state) == player) {
-                    *row = i;
-                    *col = j;
-                    state[i][j] = ' '; // Undo move
-                    return 1;
-                }
-                state[i][j] = ' '; // Undo move
-            }
-        }
-    }
-    return 0;
-}
+/* Function implementations */
 
-static int findBlockingMove(char state[3][3], char player, int *row, int *col) {
-    char opponent = (player == 'X') ? 'O' : 'X';
-    return findWinningMove(state, opponent, row, col);
-}
+static char simulatePlayout(const BitBoard* state, const unsigned char* policy) {
+    char winner = bbWinner(state);
+    if (winner != ' ')
+        return winner;
 
-static void selectRandomMove(char state[3][3], int *row, int *col) {
-    // Prioritize center, then corners, then edges
-    if (state[1][1] == ' ') {
-        *row = 1;
-        *col = 1;
-        return;
-    }
-    int preferredMoves[8][2] = {
-        {0, 0}, {0, 2}, {2, 0}, {2, 2}, // Corners
-        {0, 1}, {1, 0}, {1, 2}, {2, 1}  // Edges
-    };
-    for (int i = 0; i < 8; i++) {
-        int r = preferredMoves[i][0];
-        int c = preferredMoves[i][1];
-        if (state[r][c] == ' ') {
-            *row = r;
-            *col = c;
-            return;
-        }
-    }
-    // As a fallback, pick any empty cell
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            if (state[i][j] == ' ') {
-                *row = i;
-                *col = j;
-                return;
-            }
-        }
-    }
+    /* Each move is one table load and updates the line counts; no full-board checks */
+    PlayoutState simState;
+    playoutInit(&simState, state);
+    while (winner == ' ')
+        winner = playoutPlay(&simState, policyMove(policy, &simState.board));
+    return winner;
 }
-  
\ No newline at end of file
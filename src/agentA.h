@@ -2,10 +2,23 @@
 #define AGENTA_H
 
 #include "common.h"
+#include "engine.h"
 
+/* Agent A: MCTS with heuristic playouts and a tree kept between moves */
+typedef struct AgentA AgentA;
 
+AgentA* agentA_create(void);
+void agentA_destroy(AgentA* agent);
+void agentA_reset(AgentA* agent);
+int agentA_search(AgentA* agent, const GameState* state, const SearchConfig* config,
+                  SearchResult* result);
 
-/* TODO, Prototypes */
+/* Plays for player on the global board */
 void agentA_move(char player);
 
-#endif
\ No newline at end of file
+/* Kernels for the bench target: each runs count times from state and returns a checksum */
+int agentA_benchPlayouts(const GameState* state, int count);
+int agentA_benchSelect(const GameState* state, int count);
+int agentA_benchNodes(const GameState* state, int count);
+
+#endif
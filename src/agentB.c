@@ -1,231 +1,115 @@
 #include <stdlib.h>
 #include <stdio.h>
-#include <math.h>
-#include <float.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
 #include "common.h"
+#include "bitboard.h"
+#include "arena.h"
+#include "ttable.h"
+#include "tree.h"
+#include "parallel.h"
+#include "rng.h"
+#include "timing.h"
+#include "anytime.h"
+#include "playout.h"
+#include "batch.h"
+#include "solver.h"
+#include "symmetry.h"
+#include "ucb.h"
 #include "agentB.h"
 
-#define EXPLORATION_CONSTANT 1.41
-
-typedef struct Node {
-    char state[3][3];
-    char player; /* 'X' or 'O' */
-    int move_row;
-    int move_col;
-    int visits;
-    double wins;
-    struct Node* parent;
-    struct Node* children[9];
-    int num_children;
-} Node;
-
-/* Function prototypes */
-static Node* create_node(char state[3][3], char player, int move_row, int move_col, Node* parent);
-static void expand_node(Node* node, char agent_player, char opponent_player);
-static Node* select_best_child(Node* node);
-static char simulate_random_game(Node* node, char agent_player, char opponent_player);
-static void backpropagate(Node* node, char winner, char agentPlayer);
-static int is_terminal(char state[3][3]);
-static char get_winner(char state[3][3]);
-static void copy_state(char dest[3][3], char src[3][3]);
-static void free_tree(Node* node);
-
-void agentB_move(char player) {
-    char agent_player = player;
-    char opponent_player = (player == 'X') ? 'O' : 'X';
-
-    Node* root = create_node(board, agent_player, -1, -1, NULL);
-
-    int iterations = 5000; // Increased iterations
-    for (int i = 0; i < iterations; ++i) {
-        Node* node = root;
-
-        /* Selection */
-        while (node->num_children > 0) {
-            node = select_best_child(node);
-        }
-
-        /* Expansion */
-        if (!is_terminal(node->state)) {
-            expand_node(node, agent_player, opponent_player);
-        }
-
-        /* Simulation */
-        char winner = simulate_random_game(node, agent_player, opponent_player);
-
-        /* Backpropagation */
-        backpropagate(node, winner, agent_player);
-    }
-
-    /* Choose the best move */
-    Node* best_child = NULL;
-    double best_win_rate = -1.0;
-    for (int i = 0; i < root->num_children; ++i) {
-        Node* child = root->children[i];
-        double win_rate = child->visits > 0 ? child->wins / child->visits : 0.0;
-        if (win_rate > best_win_rate) {
-            best_win_rate = win_rate;
-            best_child = child;
-        }
-    }
-
-    if (suppressMessages == 0) {
-        printf("Agent B is considering %d possible moves.\n", root->num_children);
-        if (best_child) {
-            printf("Agent B selects move at row %d, column %d with win rate %.2f%%.\n",
-                   best_child->move_row, best_child->move_col, best_win_rate * 100);
-        } else {
-            printf("Agent B failed to select a best move, choosing randomly.\n");
-        }
-    }
+/* Agent B's policies for the MCTS core in mcts_impl.h */
+#define MCTS_AGENT AgentB
+#define MCTS_LABEL "B"
+#define MCTS_UCB_RULE UCB_RULE_B
+#define MCTS_EXPLORATION UCB_EXPLORATION_B
+#define MCTS_REUSE_TREE 0
+/* The root is treated as if the agent just moved */
+#define MCTS_ROOT_MOVER(player) bbOther(player)
+#define MCTS_DESCEND_ON_EXPAND 0
+#define MCTS_UNVISITED_RATE(proven, player) 0.0
+
+/* Uniformly random playouts, one at a time or a batch in lockstep */
+typedef struct {
+    int batch;
+    BatchRng lanes; /* Lane streams when batch > 1 */
+} Rollout;
+
+static char simulate_random_game(const BitBoard* state, Rng* rng);
+
+static int rolloutBatch(const SearchConfig* config) {
+    return config->playoutBatch > 1 ? config->playoutBatch : 1;
+}
 
-    if (best_child) {
-        board[best_child->move_row][best_child->move_col] = player;
-    } else {
-        /* Fallback to random move */
-        int i, j;
-        do {
-            i = rand() % 3;
-            j = rand() % 3;
-        } while (board[i][j] != ' ');
-        board[i][j] = player;
+static void rolloutInit(Rollout* rollout, const SearchConfig* config, Rng* rng) {
+    rollout->batch = rolloutBatch(config);
+    if (rollout->batch > 1) {
+        uint64_t lane_seed = (uint64_t)rngNext(rng) << 32;
+        batchRngInit(&rollout->lanes, lane_seed | rngNext(rng));
     }
+}
 
-    /* Free memory */
-    free_tree(root);
+static int rolloutHalfWins(Rollout* rollout, Rng* rng, const BitBoard* state, int playouts,
+                           char player) {
+    if (rollout->batch > 1)
+        return batchPlayouts(BATCH_AUTO, state, playouts, &rollout->lanes, player);
+    char winner = simulate_random_game(state, rng);
+    return solverHalfWins(winner, player);
 }
 
-/* Function implementations */
+#include "mcts_impl.h"
 
-static Node* create_node(char state[3][3], char player, int move_row, int move_col, Node* parent) {
-    Node* node = (Node*)malloc(sizeof(Node));
-    copy_state(node->state, state);
-    node->player = player;
-    node->move_row = move_row;
-    node->move_col = move_col;
-    node->visits = 0;
-    node->wins = 0.0;
-    node->parent = parent;
-    node->num_children = 0;
-    return node;
+AgentB* agentB_create(void) {
+    return mctsCreate();
 }
 
-static void expand_node(Node* node, char agent_player, char opponent_player) {
-    char next_player = (node->player == agent_player) ? opponent_player : agent_player;
-
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            if (node->state[i][j] == ' ') {
-                char new_state[3][3];
-                copy_state(new_state, node->state);
-                new_state[i][j] = next_player;
-                Node* child = create_node(new_state, next_player, i, j, node);
-                node->children[node->num_children++] = child;
-            }
-        }
-    }
+void agentB_destroy(AgentB* agent) {
+    mctsDestroy(agent);
 }
 
-static Node* select_best_child(Node* node) {
-    Node* best_child = NULL;
-    double best_value = -DBL_MAX;
-    for (int i = 0; i < node->num_children; i++) {
-        Node* child = node->children[i];
-        double win_rate = child->visits > 0 ? child->wins / child->visits : 0.0;
-        double ucb1 = win_rate +
-            EXPLORATION_CONSTANT * sqrt(log(node->visits + 1) / (child->visits + 1));
-
-        if (ucb1 > best_value) {
-            best_value = ucb1;
-            best_child = child;
-        }
-    }
-    return best_child;
+int agentB_search(AgentB* agent, const GameState* state, const SearchConfig* config,
+                  SearchResult* result) {
+    return mctsSearch(agent, state, config, result);
 }
 
-static char simulate_random_game(Node* node, char agent_player, char opponent_player) {
-    char sim_state[3][3];
-    copy_state(sim_state, node->state);
-    char current_player = (node->player == agent_player) ? opponent_player : agent_player;
-    char winner;
-    while ((winner = get_winner(sim_state)) == ' ') {
-        int move_row = -1, move_col = -1;
-        /* Find random empty cell */
-        int empty_cells[9][2];
-        int num_empty = 0;
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
-                if (sim_state[i][j] == ' ') {
-                    empty_cells[num_empty][0] = i;
-                    empty_cells[num_empty][1] = j;
-                    num_empty++;
-                }
-            }
-        }
-        if (num_empty == 0) break; // Draw
-        int rand_index = rand() % num_empty;
-        move_row = empty_cells[rand_index][0];
-        move_col = empty_cells[rand_index][1];
-        sim_state[move_row][move_col] = current_player;
-        current_player = (current_player == agent_player) ? opponent_player : agent_player;
-    }
-    return winner;
+void agentB_move(char player) {
+    move('b', player);
 }
 
-static void backpropagate(Node* node, char winner, char agentPlayer) {
-    Node* current_node = node;
-    while (current_node != NULL) {
-        current_node->visits++;
-        if (winner == agentPlayer) {
-            current_node->wins += 1.0;
-        } else if (winner == 'D') {
-            current_node->wins += 0.5;
-        }
-        /* No need to add wins if the opponent won */
-        current_node = current_node->parent;
-    }
+int agentB_benchPlayouts(const GameState* state, int count) {
+    BitBoard position = rootPosition(state);
+    Rng rng;
+    rngInit(&rng, 1);
+    int checksum = 0;
+    for (int i = 0; i < count; i++)
+        checksum += simulate_random_game(&position, &rng);
+    return checksum;
 }
 
-static int is_terminal(char state[3][3]) {
-    return get_winner(state) != ' ';
+int agentB_benchSelect(const GameState* state, int count) {
+    return mctsBenchSelect(state, count);
 }
 
-static char get_winner(char state[3][3]) {
-    /* Same logic as checkWinner() but operates on a given state */
-    /* Check rows and columns */
-    for (int i = 0; i < 3; i++) {
-        if (state[i][0] == state[i][1] && state[i][1] == state[i][2] && state[i][0] != ' ')
-            return state[i][0];
-        if (state[0][i] == state[1][i] && state[1][i] == state[2][i] && state[0][i] != ' ')
-            return state[0][i];
-    }
-    /* Check diagonals */
-    if (state[0][0] == state[1][1] && state[1][1] == state[2][2] && state[0][0] != ' ')
-        return state[0][0];
-    if (state[0][2] == state[1][1] && state[1][1] == state[2][0] && state[0][2] != ' ')
-        return state[0][2];
-    /* Check for draw or ongoing game */
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            if (state[i][j] == ' ')
-                return ' '; /* Game is ongoing */
-        }
-    }
-    return 'D'; /* Draw */
+int agentB_benchNodes(const GameState* state, int count) {
+    return mctsBenchNodes(state, count);
 }
 
-static void copy_state(char dest[3][3], char src[3][3]) {
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            dest[i][j] = src[i][j];
-        }
-    }
-}
+/* Function implementations */
 
-static void free_tree(Node* node) {
-    for (int i = 0; i < node->num_children; i++) {
-        free_tree(node->children[i]);
+static char simulate_random_game(const BitBoard* state, Rng* rng) {
+    char winner = bbWinner(state);
+    if (winner != ' ')
+        return winner;
+
+    /* Each move updates the line counts and the empty count */
+    PlayoutState sim_state;
+    playoutInit(&sim_state, state);
+    while (winner == ' ') {
+        /* Pick a random empty cell */
+        int rand_index = rngBelow(rng, sim_state.emptyCount);
+        winner = playoutPlay(&sim_state, bbNth(bbEmpty(&sim_state.board), rand_index));
     }
-    free(node);
+    return winner;
 }
@@ -1,6 +1,22 @@
 #ifndef AGENTB_H
 #define AGENTB_H
 
+#include "engine.h"
+
+/* Agent B: MCTS with uniformly random playouts */
+typedef struct AgentB AgentB;
+
+AgentB* agentB_create(void);
+void agentB_destroy(AgentB* agent);
+int agentB_search(AgentB* agent, const GameState* state, const SearchConfig* config,
+                  SearchResult* result);
+
+/* Plays for player on the global board */
 void agentB_move(char player);
 
-#endif // AGENTB_H
\ No newline at end of file
+/* Kernels for the bench target: each runs count times from state and returns a checksum */
+int agentB_benchPlayouts(const GameState* state, int count);
+int agentB_benchSelect(const GameState* state, int count);
+int agentB_benchNodes(const GameState* state, int count);
+
+#endif // AGENTB_H
@@ -1,17 +1,34 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "common.h"
+#include "bitboard.h"
+#include "rng.h"
 #include "agentC.h"
 
-void agentC_move(char player) {
-    int i, j;
-    do {
-        i = rand() % 3;
-        j = rand() % 3;
-    } while (board[i][j] != ' ');
-    board[i][j] = player;
+int agentC_search(const GameState* state, const SearchConfig* config, SearchResult* result) {
+    BitBoard position = bbFromBoard((char (*)[3])state->cells, state->toMove);
+    if (bbIsTerminal(&position))
+        return -1;
+
+    Rng rng;
+    rngInit(&rng, config->seed ? config->seed : rngStreamSeed());
+
+    /* Pick uniformly among the empty cells */
+    unsigned empty = bbEmpty(&position);
+    int cell = bbNth(empty, rngBelow(&rng, bbCount(empty)));
 
-    if (suppressMessages == 0) {
+    if (config->verbose) {
         printf("Agent C is making a random move.\n");
     }
-} 
\ No newline at end of file
+
+    memset(result, 0, sizeof(*result));
+    result->row = cell / 3;
+    result->col = cell % 3;
+    result->candidates = bbCount(empty);
+    return 0;
+}
+
+void agentC_move(char player) {
+    move('c', player);
+}
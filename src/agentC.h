@@ -1,6 +1,12 @@
 #ifndef AGENTC_H
 #define AGENTC_H
 
+#include "engine.h"
+
+/* Agent C: uniformly random moves */
+int agentC_search(const GameState* state, const SearchConfig* config, SearchResult* result);
+
+/* Plays for player on the global board */
 void agentC_move(char player);
 
-#endif // AGENTC_H 
\ No newline at end of file
+#endif // AGENTC_H
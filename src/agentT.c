@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <string.h>
+#include "common.h"
+#include "bitboard.h"
+#include "rng.h"
+#include "solver.h"
+#include "table.h"
+#include "agentT.h"
+
+/* Picks one of the cells set in the record's best-move bytes; -1 if none */
+static int pickMove(const unsigned char* moves, int cells, const SearchConfig* config, int* count) {
+    *count = 0;
+    for (int cell = 0; cell < cells; cell++)
+        *count += (moves[cell / 8] >> (cell % 8)) & 1;
+    if (*count == 0)
+        return -1;
+    Rng rng;
+    rngInit(&rng, config->seed ? config->seed : rngStreamSeed());
+    int n = rngBelow(&rng, *count);
+    for (int cell = 0; cell < cells; cell++) {
+        if (((moves[cell / 8] >> (cell % 8)) & 1) && n-- == 0)
+            return cell;
+    }
+    return -1;
+}
+
+/* Fills result from a record of a position with player to move */
+static int answer(const unsigned char* record, int cells, int cols, char player,
+                  const SearchConfig* config, SearchResult* result) {
+    int count;
+    int cell = record != NULL && record[0] != 0 ? pickMove(record + 1, cells, config, &count) : -1;
+    if (cell < 0)
+        return -1;
+    char value = (char)record[0];
+    if (config->verbose) {
+        printf("The table solves this position as a %s; playing row %d, column %d.\n",
+               value == 'D' ? "draw" : value == player ? "win" : "loss", cell / cols, cell % cols);
+    }
+    memset(result, 0, sizeof(*result));
+    result->row = cell / cols;
+    result->col = cell % cols;
+    result->winRate = solverWinRate(value, player);
+    result->candidates = count;
+    return 0;
+}
+
+int agentT_search(const GameState* state, const SearchConfig* config, SearchResult* result) {
+    const Table* table = config->table;
+    if (table == NULL || table->rows != 3 || table->cols != 3 || table->k != 3)
+        return -1;
+    BitBoard position = bbFromBoard((char (*)[3])state->cells, state->toMove);
+    if (bbIsTerminal(&position))
+        return -1;
+    unsigned char digits[BB_CELLS];
+    for (int cell = 0; cell < BB_CELLS; cell++)
+        digits[cell] = (position.x & BB_BIT(cell)) ? 1 : (position.o & BB_BIT(cell)) ? 2 : 0;
+    return answer(tableFind(table, digits, state->toMove), BB_CELLS, 3, state->toMove,
+                  config, result);
+}
+
+int agentT_searchMnk(const MnkState* state, const SearchConfig* config, SearchResult* result) {
+    const Table* table = config->table;
+    if (table == NULL || table->rows != state->rows || table->cols != state->cols ||
+        table->k != state->k || mnkWinner(state) != ' ')
+        return -1;
+    int cells = state->rows * state->cols;
+    unsigned char digits[MNK_MAX_CELLS];
+    for (int cell = 0; cell < cells; cell++)
+        digits[cell] = state->cells[cell] == 'X' ? 1 : state->cells[cell] == 'O' ? 2 : 0;
+    return answer(tableFind(table, digits, state->toMove), cells, state->cols, state->toMove,
+                  config, result);
+}
+
+void agentT_move(char player) {
+    move('t', player);
+}
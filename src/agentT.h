@@ -0,0 +1,21 @@
+#ifndef AGENTT_H
+#define AGENTT_H
+
+#include "engine.h"
+#include "mnk.h"
+
+/*
+ * Agent T: perfect play read from the solved-position table in
+ * config->table (see table.h), choosing at random among the best moves.
+ * Returns -1 when there is no table or it does not hold the position;
+ * the engine then falls back to agent A.
+ */
+int agentT_search(const GameState* state, const SearchConfig* config, SearchResult* result);
+
+/* The same on an m,n,k board, from a table written for that size */
+int agentT_searchMnk(const MnkState* state, const SearchConfig* config, SearchResult* result);
+
+/* Plays for player on the global board */
+void agentT_move(char player);
+
+#endif // AGENTT_H
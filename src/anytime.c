@@ -0,0 +1,48 @@
+#include "anytime.h"
+
+double anytimeRemaining(int budgetLeft, int done, double start, double now, double deadline) {
+    double remaining = budgetLeft > 0 ? budgetLeft : 0;
+    if (deadline > 0 && done > 0 && now > start) {
+        /* Assume the rate so far holds until the deadline */
+        double byClock = done / (now - start) * (deadline - now);
+        if (byClock < remaining)
+            remaining = byClock > 0 ? byClock : 0;
+    }
+    return remaining;
+}
+
+static double winRate(const AnytimeChild* child) {
+    return child->visits > 0 ? child->halfWins / (2.0 * child->visits) : 0.0;
+}
+
+int anytimeSettled(const AnytimeChild* children, int count, double remaining) {
+    int best = -1;
+    double bestRate = -1.0;
+    for (int i = 0; i < count; i++) {
+        if (children[i].visits == 0)
+            return 0; /* Nothing known about this move yet */
+        if (winRate(&children[i]) > bestRate) {
+            bestRate = winRate(&children[i]);
+            best = i;
+        }
+    }
+    if (best < 0)
+        return 0;
+
+    /* Worst case for the leader: all remaining playouts go through it and lose */
+    const AnytimeChild* leader = &children[best];
+    double floor = leader->fixed ? bestRate :
+        leader->halfWins / (2.0 * (leader->visits + remaining));
+    for (int i = 0; i < count; i++) {
+        if (i == best)
+            continue;
+        /* Best case for a rival: all remaining playouts go through it and win */
+        const AnytimeChild* rival = &children[i];
+        double ceiling = rival->fixed ? winRate(rival) :
+            (rival->halfWins / 2.0 + remaining) / (rival->visits + remaining);
+        /* The scan keeps the first maximum, so earlier rivals win ties */
+        if (ceiling > floor || (i < best && ceiling == floor))
+            return 0;
+    }
+    return 1;
+}
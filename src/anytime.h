@@ -0,0 +1,26 @@
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+/*
+ * Stopping rules for anytime search. The agents pick the first root child
+ * with the highest win rate; a search can stop once no other child could
+ * take that place in the playouts still to come.
+ */
+
+/* Statistics of one root child, in the order the agent scans them */
+typedef struct {
+    int halfWins; /* Two per win and one per draw */
+    int visits;
+    int fixed;    /* Terminal position: further playouts repeat the same result */
+} AnytimeChild;
+
+/* Playouts a search can still run: its iteration budget or, if tighter, what the clock allows */
+double anytimeRemaining(int budgetLeft, int done, double start, double now, double deadline);
+
+/*
+ * Returns 1 when the current choice survives even if every remaining
+ * playout is a loss through it and a win through any one rival.
+ */
+int anytimeSettled(const AnytimeChild* children, int count, double remaining);
+
+#endif // ANYTIME_H
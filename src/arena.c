@@ -0,0 +1,71 @@
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+#define SLAB_HEADER ARENA_ROUND(sizeof(ArenaSlab))
+
+static ArenaSlab* newSlab(size_t size) {
+    ArenaSlab* slab = (ArenaSlab*)malloc(SLAB_HEADER + size);
+    if (slab == NULL)
+        return NULL;
+    slab->next = NULL;
+    slab->size = size;
+    slab->used = 0;
+    return slab;
+}
+
+void arenaInit(Arena* arena, size_t slabSize) {
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->slabSize = slabSize > 0 ? ARENA_ROUND(slabSize) : ARENA_DEFAULT_SLAB;
+    arena->bytesInUse = 0;
+}
+
+void* arenaAlloc(Arena* arena, size_t size) {
+    ArenaSlab* slab = arena->current;
+    size = ARENA_ROUND(size);
+    if (arena->slabSize == 0)
+        arena->slabSize = ARENA_DEFAULT_SLAB;
+
+    /* Move on to the next kept slab, or grow the chain */
+    while (slab == NULL || slab->used + size > slab->size) {
+        ArenaSlab* next = slab ? slab->next : arena->head;
+        if (next == NULL) {
+            next = newSlab(size > arena->slabSize ? size : arena->slabSize);
+            if (next == NULL)
+                return NULL;
+            if (slab)
+                slab->next = next;
+            else
+                arena->head = next;
+        }
+        next->used = 0;
+        slab = next;
+    }
+    arena->current = slab;
+
+    void* ptr = (char*)slab + SLAB_HEADER + slab->used;
+    slab->used += size;
+    arena->bytesInUse += size;
+    return ptr;
+}
+
+void arenaReset(Arena* arena) {
+    if (arena->head)
+        arena->head->used = 0;
+    arena->current = arena->head;
+    arena->bytesInUse = 0;
+}
+
+void arenaDestroy(Arena* arena) {
+    ArenaSlab* slab = arena->head;
+    while (slab) {
+        ArenaSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    arena->head = NULL;
+    arena->current = NULL;
+    arena->bytesInUse = 0;
+}
@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/*
+ * Bump allocator for search nodes. Memory is carved out of large slabs
+ * and released all at once with arenaReset(); the slabs are kept so later
+ * searches reuse them without touching the heap. A zero-initialised
+ * Arena is ready to use.
+ */
+
+#define ARENA_DEFAULT_SLAB (1u << 20)
+
+typedef struct ArenaSlab {
+    struct ArenaSlab* next;
+    size_t size;
+    size_t used;
+} ArenaSlab;
+
+typedef struct {
+    ArenaSlab* head;
+    ArenaSlab* current;
+    size_t slabSize;
+    size_t bytesInUse;
+} Arena;
+
+void arenaInit(Arena* arena, size_t slabSize);
+void* arenaAlloc(Arena* arena, size_t size);
+void arenaReset(Arena* arena);
+void arenaDestroy(Arena* arena);
+
+#endif // ARENA_H
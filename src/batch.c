@@ -0,0 +1,222 @@
+#include <pthread.h>
+#include "rng.h"
+#include "batch.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    #include <immintrin.h>
+    #define BATCH_HAVE_AVX2 1
+    #define AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+    #define BATCH_HAVE_AVX2 0
+#endif
+
+/*
+ * Per empty-mask lookups: the number of empty cells and the n-th empty
+ * cell. Three bytes of padding let the vector kernel read each entry
+ * with a 32-bit gather.
+ */
+static unsigned char emptyCounts[512 + 3];
+static unsigned char nthEmpty[512 * BB_CELLS + 3];
+static pthread_once_t tablesOnce = PTHREAD_ONCE_INIT;
+
+static void buildTables(void) {
+    for (unsigned mask = 0; mask < 512; mask++) {
+        emptyCounts[mask] = (unsigned char)bbCount(mask);
+        for (int n = 0; n < bbCount(mask); n++)
+            nthEmpty[mask * BB_CELLS + n] = (unsigned char)bbNth(mask, n);
+    }
+}
+
+void batchRngInit(BatchRng* rng, uint64_t seed) {
+    for (int lane = 0; lane < BATCH_LANES; lane++) {
+        Rng laneRng;
+        rngInit(&laneRng, seed + (uint64_t)lane * 0x9E3779B97F4A7C15ULL);
+        for (int i = 0; i < 4; i++)
+            rng->s[i][lane] = laneRng.s[i];
+    }
+}
+
+/* rngNext() on one lane */
+static inline uint32_t laneNext(BatchRng* rng, int lane) {
+    uint32_t s0 = rng->s[0][lane], s1 = rng->s[1][lane];
+    uint32_t s2 = rng->s[2][lane], s3 = rng->s[3][lane];
+    uint32_t result = rngRotl(s1 * 5, 7) * 9;
+    uint32_t t = s1 << 9;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rngRotl(s3, 11);
+    rng->s[0][lane] = s0;
+    rng->s[1][lane] = s1;
+    rng->s[2][lane] = s2;
+    rng->s[3][lane] = s3;
+    return result;
+}
+
+/*
+ * One group of games in plain C. Every step draws a number on every lane,
+ * finished or not, and picks the empty cell (r * count) >> 32, exactly as
+ * the vector kernel does.
+ */
+static void groupScalar(const BitBoard* start, BatchRng* rng, char winners[BATCH_LANES]) {
+    unsigned x[BATCH_LANES], o[BATCH_LANES];
+    int active = BATCH_LANES;
+    for (int lane = 0; lane < BATCH_LANES; lane++) {
+        x[lane] = start->x;
+        o[lane] = start->o;
+        winners[lane] = ' ';
+    }
+    char toMove = start->toMove;
+    while (active > 0) {
+        for (int lane = 0; lane < BATCH_LANES; lane++) {
+            uint32_t r = laneNext(rng, lane);
+            if (winners[lane] != ' ')
+                continue;
+            unsigned empty = ~(x[lane] | o[lane]) & BB_FULL;
+            unsigned n = (unsigned)(((uint64_t)r * emptyCounts[empty]) >> 32);
+            unsigned* mask = (toMove == 'X') ? &x[lane] : &o[lane];
+            *mask |= BB_BIT(nthEmpty[empty * BB_CELLS + n]);
+            if (bbHasLine(*mask)) {
+                winners[lane] = toMove;
+                active--;
+            } else if ((x[lane] | o[lane]) == BB_FULL) {
+                winners[lane] = 'D';
+                active--;
+            }
+        }
+        toMove = bbOther(toMove);
+    }
+}
+
+#if BATCH_HAVE_AVX2
+
+#define ROTL_AVX2(v, k) _mm256_or_si256(_mm256_slli_epi32((v), (k)), _mm256_srli_epi32((v), 32 - (k)))
+
+AVX2_FUNCTION static inline __m256i hasLineAvx2(__m256i mask) {
+    __m256i any = _mm256_setzero_si256();
+    for (int i = 0; i < 8; i++) {
+        __m256i line = _mm256_set1_epi32(bbLines[i]);
+        any = _mm256_or_si256(any, _mm256_cmpeq_epi32(_mm256_and_si256(mask, line), line));
+    }
+    return any;
+}
+
+/* High 32 bits of the unsigned 32x32 products, lane by lane */
+AVX2_FUNCTION static inline __m256i mulHighAvx2(__m256i a, __m256i b) {
+    __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+    __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+/* Lanes whose all-ones result is set, as a bit per lane */
+AVX2_FUNCTION static inline int laneBitsAvx2(__m256i v) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(v));
+}
+
+/* groupScalar() with one lane per 32-bit element */
+AVX2_FUNCTION static void groupAvx2(const BitBoard* start, BatchRng* rng, char winners[BATCH_LANES]) {
+    __m256i s0 = _mm256_loadu_si256((const __m256i*)rng->s[0]);
+    __m256i s1 = _mm256_loadu_si256((const __m256i*)rng->s[1]);
+    __m256i s2 = _mm256_loadu_si256((const __m256i*)rng->s[2]);
+    __m256i s3 = _mm256_loadu_si256((const __m256i*)rng->s[3]);
+    const __m256i full = _mm256_set1_epi32(BB_FULL);
+    const __m256i lowByte = _mm256_set1_epi32(0xFF);
+    const __m256i cells = _mm256_set1_epi32(BB_CELLS);
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256i x = _mm256_set1_epi32(start->x);
+    __m256i o = _mm256_set1_epi32(start->o);
+    __m256i active = _mm256_set1_epi32(-1);
+    __m256i wonX = _mm256_setzero_si256(), wonO = _mm256_setzero_si256();
+    char toMove = start->toMove;
+
+    while (!_mm256_testz_si256(active, active)) {
+        __m256i r = _mm256_mullo_epi32(ROTL_AVX2(_mm256_mullo_epi32(s1, _mm256_set1_epi32(5)), 7),
+                                       _mm256_set1_epi32(9));
+        __m256i t = _mm256_slli_epi32(s1, 9);
+        s2 = _mm256_xor_si256(s2, s0);
+        s3 = _mm256_xor_si256(s3, s1);
+        s1 = _mm256_xor_si256(s1, s2);
+        s0 = _mm256_xor_si256(s0, s3);
+        s2 = _mm256_xor_si256(s2, t);
+        s3 = ROTL_AVX2(s3, 11);
+
+        __m256i empty = _mm256_andnot_si256(_mm256_or_si256(x, o), full);
+        __m256i count = _mm256_and_si256(
+            _mm256_i32gather_epi32((const int*)emptyCounts, empty, 1), lowByte);
+        __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(empty, cells), mulHighAvx2(r, count));
+        __m256i cell = _mm256_and_si256(
+            _mm256_i32gather_epi32((const int*)nthEmpty, index, 1), lowByte);
+        __m256i bit = _mm256_and_si256(_mm256_sllv_epi32(one, cell), active);
+
+        __m256i won;
+        if (toMove == 'X') {
+            x = _mm256_or_si256(x, bit);
+            won = _mm256_and_si256(hasLineAvx2(x), active);
+            wonX = _mm256_or_si256(wonX, won);
+        } else {
+            o = _mm256_or_si256(o, bit);
+            won = _mm256_and_si256(hasLineAvx2(o), active);
+            wonO = _mm256_or_si256(wonO, won);
+        }
+        __m256i filled = _mm256_cmpeq_epi32(_mm256_or_si256(x, o), full);
+        active = _mm256_andnot_si256(_mm256_or_si256(won, filled), active);
+        toMove = bbOther(toMove);
+    }
+
+    _mm256_storeu_si256((__m256i*)rng->s[0], s0);
+    _mm256_storeu_si256((__m256i*)rng->s[1], s1);
+    _mm256_storeu_si256((__m256i*)rng->s[2], s2);
+    _mm256_storeu_si256((__m256i*)rng->s[3], s3);
+
+    int xBits = laneBitsAvx2(wonX), oBits = laneBitsAvx2(wonO);
+    for (int lane = 0; lane < BATCH_LANES; lane++) {
+        winners[lane] = (xBits >> lane & 1) ? 'X' : (oBits >> lane & 1) ? 'O' : 'D';
+    }
+}
+
+#endif
+
+int batchAvailable(int kernel) {
+    if (kernel == BATCH_AUTO || kernel == BATCH_SCALAR)
+        return 1;
+#if BATCH_HAVE_AVX2
+    if (kernel == BATCH_AVX2)
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    return 0;
+}
+
+const char* batchKernelName(void) {
+    return batchAvailable(BATCH_AVX2) ? "avx2" : "scalar";
+}
+
+int batchPlayouts(int kernel, const BitBoard* start, int count, BatchRng* rng, char player) {
+    if (kernel == BATCH_AUTO)
+        kernel = batchAvailable(BATCH_AVX2) ? BATCH_AVX2 : BATCH_SCALAR;
+    if (!batchAvailable(kernel))
+        return -1;
+
+    char winner = bbWinner(start);
+    if (winner != ' ')
+        return count * ((winner == player) ? 2 : (winner == 'D') ? 1 : 0);
+
+    pthread_once(&tablesOnce, buildTables);
+    int halfWins = 0;
+    for (int done = 0; done < count; done += BATCH_LANES) {
+        char winners[BATCH_LANES];
+#if BATCH_HAVE_AVX2
+        if (kernel == BATCH_AVX2)
+            groupAvx2(start, rng, winners);
+        else
+#endif
+            groupScalar(start, rng, winners);
+
+        /* Lanes past count were played but are not counted */
+        int lanes = count - done < BATCH_LANES ? count - done : BATCH_LANES;
+        for (int lane = 0; lane < lanes; lane++)
+            halfWins += (winners[lane] == player) ? 2 : (winners[lane] == 'D') ? 1 : 0;
+    }
+    return halfWins;
+}
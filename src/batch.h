@@ -0,0 +1,39 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+#include "bitboard.h"
+
+/*
+ * Batched random playouts: many games from one position, played in
+ * lockstep as lanes of BATCH_LANES. With AVX2 (checked at run time) each
+ * group of lanes is one vector register per mask; otherwise the same
+ * steps run in plain C. Both kernels draw the same numbers from the same
+ * per-lane generators, so their results are identical.
+ */
+
+#define BATCH_LANES 8
+
+enum { BATCH_AUTO, BATCH_SCALAR, BATCH_AVX2 };
+
+/* xoshiro128** per lane, stored word by word so a vector load reads one word of every lane */
+typedef struct {
+    uint32_t s[4][BATCH_LANES];
+} BatchRng;
+
+void batchRngInit(BatchRng* rng, uint64_t seed);
+
+/* Returns 1 if the kernel can run on this CPU */
+int batchAvailable(int kernel);
+
+/* Name of the kernel BATCH_AUTO picks */
+const char* batchKernelName(void);
+
+/*
+ * Plays count uniformly random games from start and returns player's
+ * half-wins: two per win and one per draw. Returns -1 if the kernel is
+ * not available.
+ */
+int batchPlayouts(int kernel, const BitBoard* start, int count, BatchRng* rng, char player);
+
+#endif // BATCH_H
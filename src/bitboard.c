@@ -0,0 +1,31 @@
+#include "bitboard.h"
+
+BitBoard bbFromBoard(char state[3][3], char toMove) {
+    BitBoard bb;
+    bb.x = 0;
+    bb.o = 0;
+    bb.toMove = toMove;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (state[i][j] == 'X')
+                bb.x |= BB_BIT(BB_CELL(i, j));
+            else if (state[i][j] == 'O')
+                bb.o |= BB_BIT(BB_CELL(i, j));
+        }
+    }
+    return bb;
+}
+
+void bbToBoard(const BitBoard* bb, char state[3][3]) {
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            unsigned bit = BB_BIT(BB_CELL(i, j));
+            if (bb->x & bit)
+                state[i][j] = 'X';
+            else if (bb->o & bit)
+                state[i][j] = 'O';
+            else
+                state[i][j] = ' ';
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+/*
+ * Bitboard representation of a tic-tac-toe position.
+ * Cell (row, col) is bit row * 3 + col of each 9-bit mask.
+ */
+
+#define BB_CELLS 9
+#define BB_FULL 0x1FFu
+#define BB_BIT(cell) (1u << (cell))
+#define BB_CELL(row, col) ((row) * 3 + (col))
+
+typedef struct {
+    unsigned short x; /* Cells occupied by X */
+    unsigned short o; /* Cells occupied by O */
+    char toMove;      /* 'X' or 'O' */
+} BitBoard;
+
+/* Rows, columns, then diagonals */
+static const unsigned short bbLines[8] = {
+    0x007, 0x038, 0x1C0,
+    0x049, 0x092, 0x124,
+    0x111, 0x054
+};
+
+/* 3^9 boards, each with either side to move */
+#define BB_POSITIONS (2 * 19683)
+
+BitBoard bbFromBoard(char state[3][3], char toMove);
+void bbToBoard(const BitBoard* bb, char state[3][3]);
+
+static inline char bbOther(char player) {
+    return (player == 'X') ? 'O' : 'X';
+}
+
+static inline unsigned bbEmpty(const BitBoard* bb) {
+    return ~(unsigned)(bb->x | bb->o) & BB_FULL;
+}
+
+static inline unsigned bbMask(const BitBoard* bb, char player) {
+    return (player == 'X') ? bb->x : bb->o;
+}
+
+static inline int bbCount(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    int n = 0;
+    for (; mask; mask &= mask - 1)
+        n++;
+    return n;
+#endif
+}
+
+/* Index of the lowest set bit; mask must be non-zero */
+static inline int bbFirst(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    int cell = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        cell++;
+    }
+    return cell;
+#endif
+}
+
+/* Index of the n-th (0-based) set bit of mask */
+static inline int bbNth(unsigned mask, int n) {
+    while (n-- > 0)
+        mask &= mask - 1;
+    return bbFirst(mask);
+}
+
+/* Bit m is set when mask m holds a line: 512 bits, one lookup per side */
+static const unsigned bbLineMasks[16] = {
+    0x80808080u, 0xFF808080u, 0xFAF0AA80u, 0xFFF0AA80u, 0xCCCC8080u, 0xFFCC8080u, 0xFEFCAA80u, 0xFFFCAA80u,
+    0xAAAA8080u, 0xFFFAF0F0u, 0xFAFAAA80u, 0xFFFAFAF0u, 0xEEEE8080u, 0xFFFEF0F0u, 0xFFFFFFFFu, 0xFFFFFFFFu
+};
+
+static inline int bbHasLine(unsigned mask) {
+    return (int)(bbLineMasks[mask >> 5] >> (mask & 31)) & 1;
+}
+
+/* Returns 'X' or 'O' for a win, 'D' for a draw and ' ' while ongoing */
+static inline char bbWinner(const BitBoard* bb) {
+    if (bbHasLine(bb->x))
+        return 'X';
+    if (bbHasLine(bb->o))
+        return 'O';
+    return ((bb->x | bb->o) == BB_FULL) ? 'D' : ' ';
+}
+
+static inline int bbIsTerminal(const BitBoard* bb) {
+    return bbWinner(bb) != ' ';
+}
+
+/* Value of mask read as base-3 digits that are all 0 or 1 */
+static inline unsigned bbBase3(unsigned mask) {
+    static const unsigned short triple[8] = { 0, 1, 3, 4, 9, 10, 12, 13 };
+    return triple[mask & 7] + 27u * triple[(mask >> 3) & 7] + 729u * triple[(mask >> 6) & 7];
+}
+
+/*
+ * Base-3 index of the board (0 empty, 1 X, 2 O per cell), offset by 3^9
+ * when O is to move. Unique for every position below BB_POSITIONS.
+ */
+static inline unsigned bbIndex(const BitBoard* bb) {
+    return bbBase3(bb->x) + 2u * bbBase3(bb->o) + (bb->toMove == 'O' ? 19683u : 0u);
+}
+
+/* Cell that was played to get from one position to the next */
+static inline int bbMoveBetween(const BitBoard* from, const BitBoard* to) {
+    return bbFirst((unsigned)(to->x | to->o) & bbEmpty(from));
+}
+
+/* Places a mark for the side to move and passes the turn */
+static inline void bbPlay(BitBoard* bb, int cell) {
+    if (bb->toMove == 'X')
+        bb->x |= BB_BIT(cell);
+    else
+        bb->o |= BB_BIT(cell);
+    bb->toMove = bbOther(bb->toMove);
+}
+
+#endif
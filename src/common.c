@@ -1,26 +1,51 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "common.h"
-#include "agentA.h"
-#include "agentB.h"
-#include "agentC.h"
+#include "engine.h"
+#include "telemetry.h"
+#include "gamelog.h"
 
-char board[3][3];
+THREAD_LOCAL char board[3][3];
 int suppressMessages = 0;
+int clearScreen = 1;
+int searchThreads = 1;
+int rootParallel = 0;
+int searchIterations = 0;
+int searchTimeMs = 0;
+int exhaustiveSearch = 0;
+int playoutBatch = 0;
+double explorationA = 0;
+double explorationB = 0;
+const struct Table* solvedTable = NULL;
+
+/* Engine behind the board-based wrappers below, one per thread */
+static THREAD_LOCAL Engine* boardEngine;
 
 void initBoard() {
     int i, j;
     for (i = 0; i < 3; i++)
         for (j = 0; j < 3; j++)
             board[i][j] = ' ';
+    /* A tree kept from the previous game must not leak into this one */
+    if (boardEngine)
+        engineNewGame(boardEngine);
+}
+
+/* Frees the search memory the agents hold for the calling thread */
+void releaseAgents() {
+    engineDestroy(boardEngine);
+    boardEngine = NULL;
 }
 
 void displayBoard() {
+    if (clearScreen) {
 #ifdef _WIN32
-    system("cls"); // Use "cls" for Windows
+        system("cls"); // Use "cls" for Windows
 #else
-    system("clear"); // Use "clear" for Unix-based systems
+        system("clear"); // Use "clear" for Unix-based systems
 #endif
+    }
     printf("\n");
     printf(" %c | %c | %c \n", board[0][0], board[0][1], board[0][2]);
     printf("---+---+---\n");
@@ -56,12 +81,45 @@ char checkWinner() {
     return 'D'; /* Draw */
 }
 
+/* The calling thread's engine, created on first use */
+Engine* threadEngine(void) {
+    if (boardEngine == NULL)
+        boardEngine = engineCreate();
+    return boardEngine;
+}
+
+/* Search settings from the command-line globals */
+void globalSearchConfig(SearchConfig* config) {
+    memset(config, 0, sizeof(*config));
+    config->verbose = suppressMessages == 0;
+    config->threads = searchThreads;
+    config->rootParallel = rootParallel;
+    config->iterations = searchIterations;
+    config->timeBudgetMs = searchTimeMs;
+    config->exhaustive = exhaustiveSearch;
+    config->playoutBatch = playoutBatch;
+    config->table = solvedTable;
+}
+
+/* The --ucb-a or --ucb-b constant for agent; agent t searches as a when the table has no answer */
+double agentExploration(char agent) {
+    return agent == 'b' ? explorationB : explorationA;
+}
+
+/* Lets agent play for player on the global board, using the global settings */
 void move(char agent, char player) {
-    if (agent == 'a') {
-        agentA_move(player);
-    } else if (agent == 'b') {
-        agentB_move(player);
-    } else if (agent == 'c') {
-        agentC_move(player);
+    GameState state;
+    memcpy(state.cells, board, sizeof(state.cells));
+    state.toMove = player;
+
+    SearchConfig config;
+    globalSearchConfig(&config);
+    config.exploration = agentExploration(agent);
+
+    SearchResult result;
+    if (engineSearch(threadEngine(), agent, &state, &config, &result) == 0) {
+        board[result.row][result.col] = player;
+        telemetryRecord(agent, player, &result);
+        gamelogMove(player, result.row * 3 + result.col, &result);
     }
 }
\ No newline at end of file
@@ -1,11 +1,30 @@
 #ifndef COMMON_H
 #define COMMON_H
 
-extern char board[3][3];
+#include "engine.h"
+
+/* Game and search state is per thread so tournaments can run games in parallel */
+#define THREAD_LOCAL _Thread_local
+
+extern THREAD_LOCAL char board[3][3];
 extern int suppressMessages;
+extern int clearScreen;   /* 0: displayBoard() just prints, for batch runs */
+extern int searchThreads; /* Worker threads per MCTS search */
+extern int rootParallel;  /* 1: one tree per thread merged at the root */
+extern int searchIterations; /* Playouts per move, 0 for the agent's default */
+extern int searchTimeMs;     /* Wall-clock budget per move, 0 for none */
+extern int exhaustiveSearch; /* 1: never stop before the budget is spent */
+extern int playoutBatch;     /* Agent B's playouts per leaf, 0 or 1 for one */
+extern double explorationA;  /* UCB exploration constants, 0 for the agent's default */
+extern double explorationB;
+extern const struct Table* solvedTable; /* From --table, NULL for none */
 
 void initBoard();
+void releaseAgents();
 void displayBoard();
 char checkWinner();
 void move(char agent, char player);
+Engine* threadEngine(void);
+void globalSearchConfig(SearchConfig* config);
+double agentExploration(char agent);
 #endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <string.h>
+#include "engine.h"
+#include "agentA.h"
+#include "agentB.h"
+#include "agentC.h"
+#include "agentT.h"
+#include "mnk.h"
+
+/* Agents are created on first use, so an Engine only pays for what it runs */
+struct Engine {
+    AgentA* agentA;
+    AgentB* agentB;
+    Arena mnkArena; /* Nodes of the current m,n,k search */
+};
+
+Engine* engineCreate(void) {
+    return (Engine*)calloc(1, sizeof(Engine));
+}
+
+void engineDestroy(Engine* engine) {
+    if (engine == NULL)
+        return;
+    agentA_destroy(engine->agentA);
+    agentB_destroy(engine->agentB);
+    arenaDestroy(&engine->mnkArena);
+    free(engine);
+}
+
+void engineNewGame(Engine* engine) {
+    if (engine->agentA)
+        agentA_reset(engine->agentA);
+}
+
+int engineSearch(Engine* engine, char agent, const GameState* state,
+                 const SearchConfig* config, SearchResult* result) {
+    SearchConfig defaults;
+    if (config == NULL) {
+        memset(&defaults, 0, sizeof(defaults));
+        config = &defaults;
+    }
+
+    /* Agent T plays solved positions from the table and falls back to A elsewhere */
+    if (agent == 't') {
+        if (agentT_search(state, config, result) == 0)
+            return 0;
+        agent = 'a';
+    }
+
+    if (agent == 'a') {
+        if (engine->agentA == NULL && (engine->agentA = agentA_create()) == NULL)
+            return -1;
+        return agentA_search(engine->agentA, state, config, result);
+    } else if (agent == 'b') {
+        if (engine->agentB == NULL && (engine->agentB = agentB_create()) == NULL)
+            return -1;
+        return agentB_search(engine->agentB, state, config, result);
+    } else if (agent == 'c') {
+        return agentC_search(state, config, result);
+    }
+    return -1;
+}
+
+int engineSearchMnk(Engine* engine, char agent, const MnkState* state,
+                    const SearchConfig* config, SearchResult* result) {
+    SearchConfig defaults;
+    if (config == NULL) {
+        memset(&defaults, 0, sizeof(defaults));
+        config = &defaults;
+    }
+    if (agent == 't') {
+        if (agentT_searchMnk(state, config, result) == 0)
+            return 0;
+        agent = 'a';
+    }
+    return mnkSearch(&engine->mnkArena, agent, state, config, result);
+}
@@ -0,0 +1,72 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct Table;
+
+/*
+ * Reentrant entry point to the agents. Nothing here reads or writes the
+ * global board: the position comes in as a GameState, the search settings
+ * as a SearchConfig, and the move and statistics go out in a SearchResult.
+ * Each Engine holds the per-agent state (node memory, kept trees) of one
+ * caller, so separate Engines can search concurrently.
+ */
+
+typedef struct {
+    char cells[3][3]; /* ' ', 'X' or 'O' */
+    char toMove;      /* Player to choose a move for */
+} GameState;
+
+/* Zero-initialise and set what you need; zero fields take the agent's default */
+typedef struct {
+    int iterations;     /* Playouts per move */
+    double exploration; /* UCB exploration constant */
+    int timeBudgetMs;   /* Wall-clock limit per move, 0 for none */
+    uint64_t seed;      /* 0: next stream of the calling thread */
+    int verbose;        /* Print the agent's reasoning */
+    int threads;        /* Search threads */
+    int rootParallel;   /* One tree per thread, merged at the root */
+    int exhaustive;     /* Use the whole budget even once the best move is settled */
+    int playoutBatch;   /* Agent B: random games per leaf, played in lockstep */
+    const struct Table* table; /* Solved positions (table.h): agent T's moves, proven in A's and B's trees */
+} SearchConfig;
+
+/* Phases of an MCTS iteration, as indexed in SearchResult.phaseMs */
+enum { PHASE_SELECT, PHASE_EXPAND, PHASE_SIMULATE, PHASE_BACKUP, SEARCH_PHASES };
+
+typedef struct {
+    int row;            /* Chosen move, -1 when there is none */
+    int col;
+    double winRate;     /* Of the chosen move, for the player to move */
+    int iterations;     /* Playouts completed */
+    int candidates;     /* Moves considered at the root */
+    int nodes;          /* Positions in the search tree */
+    size_t nodeBytes;   /* Node memory the tree occupies */
+    int reusedVisits;   /* Visits inherited from the previous move */
+    double elapsedMs;
+    int stoppedEarly;   /* Ended before its budget: no other move could overtake */
+    int maxDepth;       /* Longest path from the root to a playout, in moves */
+    double phaseMs[SEARCH_PHASES]; /* Thread time per phase, estimated from sampled iterations;
+                                      summed over threads, each within its own search time */
+    int rootVisits[9];  /* Playouts through each root move, by row * 3 + col; 3x3 only */
+} SearchResult;
+
+typedef struct Engine Engine;
+
+Engine* engineCreate(void);
+void engineDestroy(Engine* engine);
+
+/* Forgets any tree kept from earlier moves, e.g. when a new game starts */
+void engineNewGame(Engine* engine);
+
+/*
+ * Chooses a move for state->toMove with agent 'a', 'b', 'c' or 't'.
+ * Returns 0 on success and -1 if the game is already over, the agent
+ * is unknown or there is no memory for the root of the tree.
+ */
+int engineSearch(Engine* engine, char agent, const GameState* state,
+                 const SearchConfig* config, SearchResult* result);
+
+#endif // ENGINE_H
@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "common.h"
+#include "mnk.h"
+#include "mapfile.h"
+#include "gamelog.h"
+
+/*
+ * Two blocks: game threads fill one while the writer thread writes the
+ * other. A game thread only waits when it fills its block before the
+ * writer has finished the previous one.
+ */
+static FILE* logFile;
+static GameLogHeader logHeader; /* Rewritten with the game count on close */
+static int logStats;
+static pthread_t writerThread;
+static pthread_mutex_t logLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t blockFull = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t blockFree = PTHREAD_COND_INITIALIZER;
+static unsigned char* blocks[2];
+static int active;      /* Block being filled */
+static size_t filled;   /* Bytes in it */
+static size_t pending;  /* Bytes of the other block left to write, 0 once written */
+static int closing;
+
+/* The calling thread's game, until gamelogEndGame() */
+static THREAD_LOCAL struct {
+    int open;
+    GameRecordHeader header;
+    unsigned char cells[MNK_MAX_CELLS];
+    GameMoveStats stats[MNK_MAX_CELLS];
+} current;
+
+static void* writerLoop(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&logLock);
+    for (;;) {
+        while (pending == 0 && !closing)
+            pthread_cond_wait(&blockFull, &logLock);
+        if (pending == 0)
+            break;
+        /* Appends go to the other block meanwhile */
+        const unsigned char* block = blocks[active ^ 1];
+        size_t size = pending;
+        pthread_mutex_unlock(&logLock);
+        fwrite(block, 1, size, logFile);
+        pthread_mutex_lock(&logLock);
+        pending = 0;
+        pthread_cond_broadcast(&blockFree);
+    }
+    pthread_mutex_unlock(&logLock);
+    return NULL;
+}
+
+/* Hands the filled block to the writer; called with logLock held */
+static void submitBlock(void) {
+    while (pending != 0)
+        pthread_cond_wait(&blockFree, &logLock);
+    pending = filled;
+    active ^= 1;
+    filled = 0;
+    pthread_cond_signal(&blockFull);
+}
+
+int gamelogOpen(const char* path, const GameLogHeader* header) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+        return -1;
+    blocks[0] = (unsigned char*)malloc(GAMELOG_BLOCK);
+    blocks[1] = (unsigned char*)malloc(GAMELOG_BLOCK);
+    if (blocks[0] == NULL || blocks[1] == NULL) {
+        free(blocks[0]);
+        free(blocks[1]);
+        fclose(file);
+        return -1;
+    }
+    logHeader = *header;
+    memcpy(logHeader.magic, GAMELOG_MAGIC, sizeof(logHeader.magic));
+    logHeader.games = 0;
+    fwrite(&logHeader, sizeof(logHeader), 1, file);
+    logFile = file;
+    logStats = (logHeader.flags & GAMELOG_STATS) != 0;
+    active = 0;
+    filled = pending = 0;
+    closing = 0;
+    if (pthread_create(&writerThread, NULL, writerLoop, NULL) != 0) {
+        free(blocks[0]);
+        free(blocks[1]);
+        fclose(file);
+        logFile = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void gamelogClose(int games) {
+    if (logFile == NULL)
+        return;
+    pthread_mutex_lock(&logLock);
+    if (filled > 0)
+        submitBlock();
+    closing = 1;
+    pthread_cond_signal(&blockFull);
+    pthread_mutex_unlock(&logLock);
+    pthread_join(writerThread, NULL);
+    logHeader.games = (uint32_t)games;
+    if (fseek(logFile, 0, SEEK_SET) == 0)
+        fwrite(&logHeader, sizeof(logHeader), 1, logFile);
+    fclose(logFile);
+    logFile = NULL;
+    free(blocks[0]);
+    free(blocks[1]);
+}
+
+void gamelogBeginGame(int game) {
+    current.open = logFile != NULL;
+    memset(&current.header, 0, sizeof(current.header));
+    current.header.game = (uint32_t)game;
+}
+
+void gamelogMove(char player, int cell, const SearchResult* result) {
+    if (!current.open || current.header.moves >= MNK_MAX_CELLS)
+        return;
+    int i = current.header.moves++;
+    if (i == 0)
+        current.header.opener = (uint8_t)player;
+    current.cells[i] = (unsigned char)cell;
+    current.stats[i].visits = (uint32_t)(result->iterations + result->reusedVisits);
+    current.stats[i].winRate = (uint16_t)(result->winRate * 65535.0 + 0.5);
+    current.stats[i].reserved = 0;
+}
+
+void gamelogEndGame(char winner) {
+    if (!current.open)
+        return;
+    current.open = 0;
+    current.header.winner = (uint8_t)winner;
+
+    /* Laid out here, so the lock covers one copy */
+    unsigned char record[sizeof(GameRecordHeader) + MNK_MAX_CELLS * (1 + sizeof(GameMoveStats))];
+    int moves = current.header.moves;
+    size_t size = 0;
+    memcpy(record, &current.header, sizeof(current.header));
+    size += sizeof(current.header);
+    memcpy(record + size, current.cells, (size_t)moves);
+    size += (size_t)moves;
+    if (logStats) {
+        memcpy(record + size, current.stats, moves * sizeof(GameMoveStats));
+        size += moves * sizeof(GameMoveStats);
+    }
+
+    pthread_mutex_lock(&logLock);
+    if (filled + size > GAMELOG_BLOCK)
+        submitBlock();
+    memcpy(blocks[active] + filled, record, size);
+    filled += size;
+    pthread_mutex_unlock(&logLock);
+}
+
+int gamelogMap(GameLog* log, const char* path) {
+    memset(log, 0, sizeof(*log));
+    size_t size = 0;
+    void* data = mapFile(path, &size);
+    if (data == NULL)
+        return -1;
+    if (size < sizeof(GameLogHeader) || memcmp(data, GAMELOG_MAGIC, sizeof(log->header.magic)) != 0) {
+        unmapFile(data, size);
+        return -1;
+    }
+    memcpy(&log->header, data, sizeof(log->header));
+    log->next = (const unsigned char*)data + sizeof(GameLogHeader);
+    log->end = (const unsigned char*)data + size;
+    log->data = data;
+    log->size = size;
+    return 0;
+}
+
+void gamelogUnmap(GameLog* log) {
+    if (log->data != NULL)
+        unmapFile(log->data, log->size);
+    memset(log, 0, sizeof(*log));
+}
+
+int gamelogNext(GameLog* log, GameRecord* record) {
+    GameRecordHeader header;
+    do {
+        if ((size_t)(log->end - log->next) < sizeof(header))
+            return 0;
+        memcpy(&header, log->next, sizeof(header));
+        size_t statsSize = (log->header.flags & GAMELOG_STATS) ? header.moves * sizeof(GameMoveStats) : 0;
+        size_t size = sizeof(header) + header.moves + statsSize;
+        if ((size_t)(log->end - log->next) < size)
+            return 0;
+        record->game = header.game;
+        record->moves = header.moves;
+        record->opener = (char)header.opener;
+        record->winner = (char)header.winner;
+        record->cells = log->next + sizeof(header);
+        record->stats = statsSize > 0 ? record->cells + header.moves : NULL;
+        log->next += size;
+    } while (log->header.games > 0 && header.game > log->header.games);
+    return 1;
+}
+
+GameMoveStats gamelogStats(const GameRecord* record, int i) {
+    GameMoveStats stats;
+    /* Records are packed, so the statistics may be unaligned */
+    memcpy(&stats, record->stats + i * sizeof(GameMoveStats), sizeof(stats));
+    return stats;
+}
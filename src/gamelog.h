@@ -0,0 +1,97 @@
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "engine.h"
+
+/*
+ * Binary game records of a tournament, for runs too large to log as text.
+ *
+ * File layout: a GameLogHeader, then one record per game in the order
+ * the games finished. A run that a sequential test ended keeps the
+ * games that finished after the deciding one; the header's game count
+ * marks where the counted games stop, and the reader skips the rest.
+ * Each record:
+ *   GameRecordHeader  8 bytes
+ *   moves             one byte per move, the cell (row * cols + col)
+ *   statistics        with GAMELOG_STATS, one GameMoveStats per move
+ * Integers are in the byte order of the machine that wrote the file.
+ *
+ * Game threads hand finished records to a writer thread that writes them
+ * in blocks of GAMELOG_BLOCK bytes. The reader maps the file and walks
+ * the records in place.
+ */
+
+#define GAMELOG_MAGIC "MCTSLOG1"
+#define GAMELOG_STATS 1          /* Header flag: moves carry search statistics */
+#define GAMELOG_BLOCK (1 << 20)  /* Bytes per write */
+
+typedef struct {
+    char magic[8];
+    uint64_t seed;
+    uint32_t games;              /* Games the run counted, set on close; 0 reads every record */
+    uint8_t rows, cols, k;
+    uint8_t flags;
+    uint8_t first, second;       /* Agents playing X and O */
+    uint8_t reserved[6];
+} GameLogHeader;
+
+typedef struct {
+    uint32_t game;               /* Number in the tournament, from 1 */
+    uint8_t moves;
+    uint8_t opener;              /* 'X' or 'O' */
+    uint8_t winner;              /* 'X', 'O' or 'D' */
+    uint8_t reserved;
+} GameRecordHeader;
+
+typedef struct {
+    uint32_t visits;             /* Root visits behind the move */
+    uint16_t winRate;            /* Of the move, in 1/65535ths */
+    uint16_t reserved;
+} GameMoveStats;
+
+/* Writing. gamelogOpen() starts the writer thread; returns 0 on success */
+int gamelogOpen(const char* path, const GameLogHeader* header);
+
+/* Writes what is buffered, stops the writer thread and stores games, the games the run counted */
+void gamelogClose(int games);
+
+/* Starts the calling thread's record of game, unless no log is open */
+void gamelogBeginGame(int game);
+
+/* Adds a move of player to the calling thread's game */
+void gamelogMove(char player, int cell, const SearchResult* result);
+
+/* Queues the calling thread's game for writing */
+void gamelogEndGame(char winner);
+
+/* Reading */
+typedef struct {
+    GameLogHeader header;
+    const unsigned char* next;   /* Next record */
+    const unsigned char* end;
+    void* data;                  /* The whole file, mapped */
+    size_t size;
+} GameLog;
+
+/* A record in place in the mapping */
+typedef struct {
+    uint32_t game;
+    int moves;
+    char opener, winner;
+    const unsigned char* cells;
+    const unsigned char* stats;  /* GameMoveStats per move, NULL without GAMELOG_STATS */
+} GameRecord;
+
+/* Maps the file at path; returns 0, or -1 if it is missing or not a game log */
+int gamelogMap(GameLog* log, const char* path);
+void gamelogUnmap(GameLog* log);
+
+/* The next counted record; returns 0 at the end of the log or at a truncated record */
+int gamelogNext(GameLog* log, GameRecord* record);
+
+/* Statistics of move i of a record with statistics */
+GameMoveStats gamelogStats(const GameRecord* record, int i);
+
+#endif // GAMELOG_H
@@ -11,165 +11,511 @@
 #include <string.h>
 
 #include "common.h"
+#include "rng.h"
 #include "agentA.h"
 #include "agentB.h"
 #include "agentC.h"
+#include "parallel.h"
+#include "tournament.h"
+#include "mnk.h"
+#include "table.h"
+#include "telemetry.h"
+#include "sprt.h"
+#include "gamelog.h"
 
 #define AGENT_A_PLAYER 'X'
 #define AGENT_B_PLAYER 'O'
 
-int main() {
-	srand(time(NULL));
-	int choice;
-	printf("Select an option:\n");
-	printf("1. Watch a single game\n");
-	printf("2. Run & plot multiple games\n");
-	printf("3. Play against an MCTS algorithm\n");
-	printf("Enter your choice: ");
-	scanf("%d", &choice);
-
-	if (choice == 1) {
+enum { MODE_MENU, MODE_WATCH, MODE_TOURNAMENT, MODE_PLAY };
+enum { FORMAT_NONE, FORMAT_CSV, FORMAT_JSON };
+
+/* Everything the prompts ask for; unset fields are prompted for, or defaulted in batch mode */
+typedef struct {
+	int mode;
+	char firstAgent, secondAgent; /* Option 2 */
+	char opponent;                /* Option 3 */
+	int numGames;
+	int excludeDraws;
+	int quiet;
+	int format;
+	const char* output;
+	int plot;
+	int rows, cols, k;            /* Option 2 on an m,n,k board, k = 0 for 3x3 */
+	const char* record;           /* Option 2 writes its games here (gamelog.h) */
+	int recordStats;
+	int sprt;                     /* Option 2 stops once a sequential test settles */
+	SprtConfig sprtConfig;
+} Options;
+
+static void usage(const char* program) {
+	printf("Usage: %s [options]\n", program);
+	printf("  -t, --threads N      search threads per MCTS move (default 1)\n");
+	printf("  -r, --root-parallel  give each thread its own tree, merged at the root\n");
+	printf("  -s, --seed N         seed for all random decisions (default: current time)\n");
+	printf("  -j, --jobs N         games played in parallel in option 2 (0: one per CPU)\n");
+	printf("  -n, --iterations N   playouts per MCTS move (default: the agent's own)\n");
+	printf("  -m, --time-ms N      wall-clock budget per MCTS move in milliseconds\n");
+	printf("  -e, --exhaustive     spend the whole budget even once the move is settled\n");
+	printf("  --batch N            agent B plays N random games per leaf in lockstep\n");
+	printf("  --ucb-a C, --ucb-b C UCB exploration constant of agent A (default 0.7) or B (1.41)\n");
+	printf("  --table FILE         solved positions from a table by mcts_tablegen: enables\n");
+	printf("                       agent t, and agents A and B search with them proven\n");
+	printf("  --telemetry FILE     write statistics of every searched move as JSON lines\n");
+	printf("                       (- for stdout)\n");
+	printf("Batch mode (no prompts, no screen clearing):\n");
+	printf("  --mode M             watch, tournament or play (or 1, 2, 3)\n");
+	printf("  --first A            first agent of a tournament, plays X (default a)\n");
+	printf("  --second A           second agent of a tournament, plays O (default b)\n");
+	printf("  --games N            games in a tournament (default 100)\n");
+	printf("  --exclude-draws      leave draws out of the success rates\n");
+	printf("  --opponent A         agent to play against in play mode (default a)\n");
+	printf("  -q, --quiet          suppress messages during simulation\n");
+	printf("  --format F           write the results as csv or json\n");
+	printf("  -o, --output FILE    write the results to FILE instead of stdout\n");
+	printf("  --plot               plot a tournament with gnuplot\n");
+	printf("  --board MxNxK        play a tournament on M rows, N columns, K in a row\n");
+	printf("                       (3x3x3, 7x7x4 or 15x15x5)\n");
+	printf("  --record FILE        write every tournament game to FILE as a binary record\n");
+	printf("                       (read it with mcts_gamelog)\n");
+	printf("  --record-stats       with --record, add root visits and win rate to each move\n");
+	printf("  --sprt               end a tournament once a sequential probability ratio test\n");
+	printf("                       shows one agent stronger or both equal; --games is the cap\n");
+	printf("  --sprt-elo E0,E1     Elo difference of no and of a real gain (default 0,20)\n");
+	printf("  --sprt-alpha A       false positive rate of the test (default 0.05)\n");
+	printf("  --sprt-beta B        false negative rate of the test (default 0.05)\n");
+}
+
+static int parseMode(const char* text) {
+	if (strcmp(text, "1") == 0 || strcmp(text, "watch") == 0)
+		return MODE_WATCH;
+	if (strcmp(text, "2") == 0 || strcmp(text, "tournament") == 0)
+		return MODE_TOURNAMENT;
+	if (strcmp(text, "3") == 0 || strcmp(text, "play") == 0)
+		return MODE_PLAY;
+	return -1;
+}
+
+static int validAgent(char agent) {
+	return agent == 'a' || agent == 'b' || agent == 'c' || (agent == 't' && solvedTable != NULL);
+}
+
+static int promptYesNo(const char* question) {
+	char answer;
+	printf("%s (y/n): ", question);
+	scanf(" %c", &answer);
+	return (answer == 'y' || answer == 'Y') ? 1 : 0;
+}
+
+static void plotResults(char firstAgent, char secondAgent, int excludeDraws) {
+	/* change this to the directory of your gnuplot binary!! */
+	#ifdef __APPLE__
+		FILE *gnuplotPipe = popen("/opt/homebrew/bin/gnuplot -persistent", "w");
+	#elif _WIN32
+		FILE *gnuplotPipe = popen("C:/gnuplot -persistent", "w");
+	#else
+		FILE *gnuplotPipe = popen("gnuplot -persistent", "w");
+	#endif
+	if (gnuplotPipe) {
+		fprintf(gnuplotPipe, "set title 'Agent Success Rates Over Games'\n");
+		fprintf(gnuplotPipe, "set xlabel 'Number of Games'\n");
+		fprintf(gnuplotPipe, "set ylabel 'Success Rate'\n");
+		fprintf(gnuplotPipe, "plot 'results.dat' using 1:2 with lines lw 5 title 'Agent %c', \\\n", firstAgent);
+		fprintf(gnuplotPipe, "     'results.dat' using 1:3 with lines lw 5 title 'Agent %c'", secondAgent);
+		if (!excludeDraws) {
+			fprintf(gnuplotPipe, ", \\\n     'results.dat' using 1:4 with lines lw 5 title 'Draws'\n");
+		} else {
+			fprintf(gnuplotPipe, "\n");
+		}
+		fprintf(gnuplotPipe, "pause -1\n");
+		fflush(gnuplotPipe);
+		pclose(gnuplotPipe);
+	} else {
+		printf("Error: Could not open gnuplot.\n");
+	}
+}
+
+/* The sequential test's verdict and the Elo estimate, in the chosen format */
+static void reportSprt(const Tournament* tournament, int games, FILE* out, int format) {
+	const Sprt* sprt = tournament->sprt;
+	const SprtConfig* config = &sprt->config;
+	double elo, low, high;
+	sprtElo(sprt, &elo, &low, &high);
+	if (format == FORMAT_JSON) {
+		fprintf(out, ",\"sprt\":{\"result\":\"%s\",\"games_budget\":%d,\"elo0\":%g,\"elo1\":%g,"
+			"\"alpha\":%g,\"beta\":%g,\"llr_first\":%.3f,\"llr_second\":%.3f,\"lower\":%.3f,"
+			"\"upper\":%.3f,\"elo\":%.1f,\"elo_low\":%.1f,\"elo_high\":%.1f}",
+			sprtResultName(sprt->result), tournament->numGames, config->elo0, config->elo1,
+			config->alpha, config->beta, sprt->llrFirst, sprt->llrSecond, sprt->lower, sprt->upper,
+			elo, low, high);
+	} else if (format == FORMAT_CSV) {
+		fprintf(out, "# sprt=%s games=%d elo=%.1f elo_low=%.1f elo_high=%.1f\n",
+			sprtResultName(sprt->result), games, elo, low, high);
+	} else {
+		if (sprt->result == SPRT_FIRST || sprt->result == SPRT_SECOND) {
+			printf("SPRT: agent %c is stronger", sprt->result == SPRT_FIRST ?
+				tournament->firstAgent : tournament->secondAgent);
+		} else if (sprt->result == SPRT_EQUAL) {
+			printf("SPRT: neither agent is stronger by %g Elo", config->elo1);
+		} else {
+			printf("SPRT: inconclusive");
+		}
+		printf(" after %d of %d games; Elo difference %+.1f (95%% CI %+.1f to %+.1f).\n",
+			games, tournament->numGames, elo, low, high);
+	}
+}
+
+/*
+ * Tallies the first games games in order. The running success rates go
+ * to results.dat (the gnuplot input) when dataFile is set, and with the
+ * totals to out in the chosen format.
+ */
+static void reportTournament(const Tournament* tournament, const char* winners, int games,
+		int excludeDraws, FILE* dataFile, FILE* out, int format) {
+	int agent1Wins = 0, agent2Wins = 0, draws = 0;
+	if (format == FORMAT_CSV) {
+		fprintf(out, "game,winner,first_rate,second_rate,draw_rate\n");
+	} else if (format == FORMAT_JSON) {
+		fprintf(out, "{\"first\":\"%c\",\"second\":\"%c\",\"games\":%d,\"seed\":%llu,"
+			"\"exclude_draws\":%s,\"results\":[", tournament->firstAgent, tournament->secondAgent,
+			games, (unsigned long long)tournament->seed, excludeDraws ? "true" : "false");
+	}
+
+	for (int i = 1; i <= games; i++) {
+		char winner = winners[i - 1];
+		if (winner == 'X') {
+			if (suppressMessages == 0) {
+				printf("Agent %c wins game %d.\n", tournament->firstAgent, i);
+			}
+			agent1Wins++;
+		} else if (winner == 'O') {
+			if (suppressMessages == 0) {
+				printf("Agent %c wins game %d.\n", tournament->secondAgent, i);
+			}
+			agent2Wins++;
+		} else if (winner == 'D') {
+			if (suppressMessages == 0) {
+				printf("Game %d is a draw.\n", i);
+			}
+			draws++;
+		}
+
+		int totalGames = excludeDraws ? (agent1Wins + agent2Wins) : i;
+		float agent1SuccessRate = totalGames > 0 ? (float)agent1Wins / totalGames : 0.0f;
+		float agent2SuccessRate = totalGames > 0 ? (float)agent2Wins / totalGames : 0.0f;
+		float drawRate = excludeDraws ? 0.0f : (float)draws / i;
+
+		if (dataFile) {
+			fprintf(dataFile, "%d %f %f %f\n", i,
+				agent1SuccessRate,
+				agent2SuccessRate,
+				drawRate);
+		}
+		if (format == FORMAT_CSV) {
+			fprintf(out, "%d,%c,%f,%f,%f\n", i, winner, agent1SuccessRate, agent2SuccessRate, drawRate);
+		} else if (format == FORMAT_JSON) {
+			fprintf(out, "%s{\"game\":%d,\"winner\":\"%c\",\"first_rate\":%f,\"second_rate\":%f,"
+				"\"draw_rate\":%f}", i > 1 ? "," : "", i, winner,
+				agent1SuccessRate, agent2SuccessRate, drawRate);
+		}
+	}
+
+	if (format == FORMAT_JSON) {
+		fprintf(out, "],\"first_wins\":%d,\"second_wins\":%d,\"draws\":%d",
+			agent1Wins, agent2Wins, draws);
+	}
+	if (tournament->sprt)
+		reportSprt(tournament, games, out, format);
+	if (format == FORMAT_JSON)
+		fprintf(out, "}\n");
+}
+
+int main(int argc, char* argv[]) {
+	static Table table; /* Mapped for the life of the process */
+	uint64_t seed = (uint64_t)time(NULL);
+	int jobs = 1;
+	Options options = { .mode = MODE_MENU, .excludeDraws = -1, .quiet = -1, .format = FORMAT_NONE };
+	for (int i = 1; i < argc; i++) {
+		if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) && i + 1 < argc) {
+			searchThreads = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "--root-parallel") == 0) {
+			rootParallel = 1;
+		} else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seed") == 0) && i + 1 < argc) {
+			seed = strtoull(argv[++i], NULL, 10);
+		} else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+			jobs = atoi(argv[++i]);
+			if (jobs <= 0)
+				jobs = parallelCpuCount();
+		} else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "--iterations") == 0) && i + 1 < argc) {
+			searchIterations = atoi(argv[++i]);
+		} else if ((strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--time-ms") == 0) && i + 1 < argc) {
+			searchTimeMs = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--exhaustive") == 0) {
+			exhaustiveSearch = 1;
+		} else if (strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+			playoutBatch = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--ucb-a") == 0 && i + 1 < argc) {
+			explorationA = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--ucb-b") == 0 && i + 1 < argc) {
+			explorationB = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--table") == 0 && i + 1 < argc) {
+			i++;
+			if (tableOpen(&table, argv[i]) != 0) {
+				fprintf(stderr, "Error: %s is not a solved-position table.\n", argv[i]);
+				return 1;
+			}
+			solvedTable = &table;
+		} else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+			i++;
+			if (telemetryOpen(argv[i]) != 0) {
+				fprintf(stderr, "Error: Could not open %s.\n", argv[i]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--mode") == 0 && i + 1 < argc) {
+			options.mode = parseMode(argv[++i]);
+			if (options.mode < 0) {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--first") == 0 && i + 1 < argc) {
+			options.firstAgent = argv[++i][0];
+		} else if (strcmp(argv[i], "--second") == 0 && i + 1 < argc) {
+			options.secondAgent = argv[++i][0];
+		} else if (strcmp(argv[i], "--opponent") == 0 && i + 1 < argc) {
+			options.opponent = argv[++i][0];
+		} else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+			options.numGames = atoi(argv[++i]);
+		} else if (strcmp(argv[i], "--exclude-draws") == 0) {
+			options.excludeDraws = 1;
+		} else if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+			options.quiet = 1;
+		} else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			i++;
+			if (strcmp(argv[i], "csv") == 0) {
+				options.format = FORMAT_CSV;
+			} else if (strcmp(argv[i], "json") == 0) {
+				options.format = FORMAT_JSON;
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) && i + 1 < argc) {
+			options.output = argv[++i];
+		} else if (strcmp(argv[i], "--plot") == 0) {
+			options.plot = 1;
+		} else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			options.record = argv[++i];
+		} else if (strcmp(argv[i], "--record-stats") == 0) {
+			options.recordStats = 1;
+		} else if (strcmp(argv[i], "--sprt") == 0) {
+			options.sprt = 1;
+		} else if (strcmp(argv[i], "--sprt-elo") == 0 && i + 1 < argc) {
+			options.sprt = 1;
+			if (sscanf(argv[++i], "%lf,%lf", &options.sprtConfig.elo0, &options.sprtConfig.elo1) != 2) {
+				usage(argv[0]);
+				return 1;
+			}
+		} else if (strcmp(argv[i], "--sprt-alpha") == 0 && i + 1 < argc) {
+			options.sprt = 1;
+			options.sprtConfig.alpha = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--sprt-beta") == 0 && i + 1 < argc) {
+			options.sprt = 1;
+			options.sprtConfig.beta = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--board") == 0 && i + 1 < argc) {
+			i++;
+			if (sscanf(argv[i], "%dx%dx%d", &options.rows, &options.cols, &options.k) != 3 ||
+				!mnkSupported(options.rows, options.cols, options.k)) {
+				fprintf(stderr, "Error: Unsupported board %s.\n", argv[i]);
+				return 1;
+			}
+		} else {
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	/* A mode on the command line means batch mode: defaults instead of prompts */
+	int batch = options.mode != MODE_MENU;
+	if (batch) {
+		clearScreen = 0;
+		if (options.excludeDraws < 0)
+			options.excludeDraws = 0;
+		if (options.quiet < 0)
+			options.quiet = 0;
+	}
+	if (options.k > 0 && batch && options.mode != MODE_TOURNAMENT) {
+		fprintf(stderr, "Error: --board only applies to tournaments.\n");
+		return 1;
+	}
+	FILE* out = stdout;
+	if (options.output && options.format != FORMAT_NONE) {
+		out = fopen(options.output, "w");
+		if (out == NULL) {
+			fprintf(stderr, "Error: Could not open %s.\n", options.output);
+			return 1;
+		}
+	}
+
+	rngSetSeed(seed);
+	Rng rng;
+	rngInit(&rng, rngStreamSeed());
+	int choice = options.mode;
+	if (!batch) {
+		printf("Select an option:\n");
+		printf("1. Watch a single game\n");
+		printf("2. Run & plot multiple games\n");
+		printf("3. Play against an MCTS algorithm\n");
+		printf("Enter your choice: ");
+		scanf("%d", &choice);
+	}
+
+	if (choice == MODE_WATCH) {
 		initBoard();
 		char winner = ' ';
-		int turn = rand() % 2; // Randomly select starting player (0 or 1)
+		int turn = rngBelow(&rng, 2); // Randomly select starting player (0 or 1)
+		suppressMessages = options.quiet > 0;
 		while (winner == ' ') {
-			displayBoard();
+			if (!suppressMessages)
+				displayBoard();
 			if (turn == 0) {
-				printf("Agent A's turn.\n");
+				if (!suppressMessages)
+					printf("Agent A's turn.\n");
 				agentA_move(AGENT_A_PLAYER);
 				turn = 1;
 			} else {
-				printf("Agent B's turn.\n");
+				if (!suppressMessages)
+					printf("Agent B's turn.\n");
 				agentB_move(AGENT_B_PLAYER);
 				turn = 0;
 			}
 			winner = checkWinner();
-			SLEEP(800); // Wait 500ms between moves
+			if (!batch)
+				SLEEP(800); // Wait 500ms between moves
+		}
+		if (!suppressMessages) {
+			displayBoard();
+			if (winner == 'D') {
+				printf("It's a draw!\n");
+			} else if (winner == AGENT_A_PLAYER) {
+				printf("Agent A (Player %c) wins!\n", winner);
+			} else if (winner == AGENT_B_PLAYER) {
+				printf("Agent B (Player %c) wins!\n", winner);
+			}
+		}
+		if (options.format == FORMAT_CSV) {
+			fprintf(out, "first,second,winner\na,b,%c\n", winner);
+		} else if (options.format == FORMAT_JSON) {
+			fprintf(out, "{\"first\":\"a\",\"second\":\"b\",\"seed\":%llu,\"winner\":\"%c\"}\n",
+				(unsigned long long)seed, winner);
+		}
+		suppressMessages = 0;
+	} else if (choice == MODE_TOURNAMENT) {
+		char firstAgent = options.firstAgent, secondAgent = options.secondAgent;
+		if (firstAgent == 0) {
+			firstAgent = 'a';
+			if (!batch) {
+				printf("Enter first player agent (a - Agent A, b - Agent B, c - Agent C): ");
+				scanf(" %c", &firstAgent);
+			}
+		}
+		if (secondAgent == 0) {
+			secondAgent = 'b';
+			if (!batch) {
+				printf("Enter second player agent (a - Agent A, b - Agent B, c - Agent C): ");
+				scanf(" %c", &secondAgent);
+			}
+		}
+		if (batch && (!validAgent(firstAgent) || !validAgent(secondAgent))) {
+			fprintf(stderr, "Error: Agents must be a, b, c or (with --table) t.\n");
+			return 1;
 		}
-		displayBoard();
-		if (winner == 'D') {
-			printf("It's a draw!\n");
-		} else if (winner == AGENT_A_PLAYER) {
-			printf("Agent A (Player %c) wins!\n", winner);
-		} else if (winner == AGENT_B_PLAYER) {
-			printf("Agent B (Player %c) wins!\n", winner);
-		}
-	} else if (choice == 2) {
-		char firstAgent, secondAgent;
-		char firstPlayerSymbol, secondPlayerSymbol;
-		printf("Enter first player agent (a - Agent A, b - Agent B, c - Agent C): ");
-		scanf(" %c", &firstAgent);
-		printf("Enter second player agent (a - Agent A, b - Agent B, c - Agent C): ");
-		scanf(" %c", &secondAgent);
-
-		// Assign player symbols
-		firstPlayerSymbol = 'X';
-		secondPlayerSymbol = 'O';
-
-		int numGames;
-		printf("Enter the number of games to run: ");
-		scanf("%d", &numGames);
-
-		char excludeDrawsChoice;
-		printf("Exclude draws from results? (y/n): ");
-		scanf(" %c", &excludeDrawsChoice);
-		int excludeDraws = (excludeDrawsChoice == 'y' || excludeDrawsChoice == 'Y') ? 1 : 0;
-
-		char suppressMessagesChoice;
-		printf("Suppress messages during simulation? (y/n): ");
-		scanf(" %c", &suppressMessagesChoice);
-		suppressMessages = (suppressMessagesChoice == 'y' || suppressMessagesChoice == 'Y') ? 1 : 0;
-
-		int agent1Wins = 0, agent2Wins = 0, draws = 0;
-		FILE *fp = fopen("results.dat", "w");
-
-		for (int i = 1; i <= numGames; i++) {
-				initBoard();
-				char winner = ' ';
-				int turn = rand() % 2; /* Randomly select starting player (0 or 1) */
-				while (winner == ' ') {
-						if (turn == 0) {
-								move(firstAgent, firstPlayerSymbol);
-								turn = 1;
-						} else {
-								move(secondAgent, secondPlayerSymbol);
-								turn = 0;
-						}
-						winner = checkWinner();
-				}
-				if (winner == firstPlayerSymbol) {
-						if (suppressMessages == 0) {
-								printf("Agent %c wins game %d.\n", firstAgent, i);
-						}
-						agent1Wins++;
-				} else if (winner == secondPlayerSymbol) {
-						if (suppressMessages == 0) {
-								printf("Agent %c wins game %d.\n", secondAgent, i);
-						}
-						agent2Wins++;
-				} else if (winner == 'D') {
-						if (suppressMessages == 0) {
-								printf("Game %d is a draw.\n", i);
-						}
-						draws++;
-				}
 
-				int totalGames = excludeDraws ? (agent1Wins + agent2Wins) : i;
-				float agent1SuccessRate = totalGames > 0 ? (float)agent1Wins / totalGames : 0.0f;
-				float agent2SuccessRate = totalGames > 0 ? (float)agent2Wins / totalGames : 0.0f;
-				float drawRate = excludeDraws ? 0.0f : (float)draws / i;
-
-				fprintf(fp, "%d %f %f %f\n", i,
-								agent1SuccessRate,
-								agent2SuccessRate,
-								drawRate);
-		}
-		fclose(fp);
-
-		/* change this to the directory of your gnuplot binary!! */
-		#ifdef __APPLE__
-				FILE *gnuplotPipe = popen("/opt/homebrew/bin/gnuplot -persistent", "w");
-		#elif _WIN32
-				FILE *gnuplotPipe = popen("C:/gnuplot -persistent", "w");
-		#else
-				FILE *gnuplotPipe = popen("gnuplot -persistent", "w");
-		#endif
-		if (gnuplotPipe) {
-				fprintf(gnuplotPipe, "set title 'Agent Success Rates Over Games'\n");
-				fprintf(gnuplotPipe, "set xlabel 'Number of Games'\n");
-				fprintf(gnuplotPipe, "set ylabel 'Success Rate'\n");
-				fprintf(gnuplotPipe, "plot 'results.dat' using 1:2 with lines lw 5 title 'Agent %c', \\\n", firstAgent);
-				fprintf(gnuplotPipe, "     'results.dat' using 1:3 with lines lw 5 title 'Agent %c'", secondAgent);
-				if (!excludeDraws) {
-						fprintf(gnuplotPipe, ", \\\n     'results.dat' using 1:4 with lines lw 5 title 'Draws'\n");
-				} else {
-						fprintf(gnuplotPipe, "\n");
-				}
-				fprintf(gnuplotPipe, "pause -1\n");
-				fflush(gnuplotPipe);
-				pclose(gnuplotPipe);
-		} else {
-				printf("Error: Could not open gnuplot.\n");
+		int numGames = options.numGames;
+		if (numGames <= 0) {
+			numGames = 100;
+			if (!batch) {
+				printf("Enter the number of games to run: ");
+				scanf("%d", &numGames);
+			}
 		}
 
-		printf("Results have been written to results.dat and plotted using gnuplot.\n");
+		int excludeDraws = options.excludeDraws >= 0 ? options.excludeDraws :
+			promptYesNo("Exclude draws from results?");
+		suppressMessages = options.quiet >= 0 ? options.quiet :
+			promptYesNo("Suppress messages during simulation?");
+
+		/* Play the games (in parallel unless their messages are wanted), then tally in order */
+		Tournament tournament;
+		tournament.firstAgent = firstAgent;
+		tournament.secondAgent = secondAgent;
+		tournament.numGames = numGames;
+		tournament.jobs = suppressMessages ? jobs : 1;
+		tournament.seed = seed;
+		tournament.rows = options.rows;
+		tournament.cols = options.cols;
+		tournament.k = options.k;
+		Sprt sprt;
+		if (options.sprt)
+			sprtInit(&sprt, &options.sprtConfig);
+		tournament.sprt = options.sprt ? &sprt : NULL;
+		if (options.record) {
+			GameLogHeader header;
+			memset(&header, 0, sizeof(header));
+			header.rows = (uint8_t)(options.k > 0 ? options.rows : 3);
+			header.cols = (uint8_t)(options.k > 0 ? options.cols : 3);
+			header.k = (uint8_t)(options.k > 0 ? options.k : 3);
+			header.flags = options.recordStats ? GAMELOG_STATS : 0;
+			header.first = (uint8_t)firstAgent;
+			header.second = (uint8_t)secondAgent;
+			header.seed = seed;
+			if (gamelogOpen(options.record, &header) != 0) {
+				fprintf(stderr, "Error: Could not open %s.\n", options.record);
+				return 1;
+			}
+		}
+		char *winners = (char *)malloc(numGames > 0 ? numGames : 1);
+		int played = runTournament(&tournament, winners);
+		gamelogClose(played);
+
+		/* The interactive menu always plots; batch runs only when asked */
+		int plot = !batch || options.plot;
+		FILE *fp = plot ? fopen("results.dat", "w") : NULL;
+		reportTournament(&tournament, winners, played, excludeDraws, fp, out, options.format);
+		if (fp)
+			fclose(fp);
+		free(winners);
+
+		if (plot) {
+			plotResults(firstAgent, secondAgent, excludeDraws);
+			printf("Results have been written to results.dat and plotted using gnuplot.\n");
+		}
 
 		/* Reset suppressMessages */
 		suppressMessages = 0;
-	} else if (choice == 3) {
-		char opponent;
-		printf("Select your opponent ('a' for Agent A, 'b' for Agent B, 'c' for Agent C): ");
-		scanf(" %c", &opponent);
+	} else if (choice == MODE_PLAY) {
+		char opponent = options.opponent;
+		if (opponent == 0) {
+			opponent = 'a';
+			if (!batch) {
+				printf("Select your opponent ('a' for Agent A, 'b' for Agent B, 'c' for Agent C): ");
+				scanf(" %c", &opponent);
+			}
+		}
+		if (!validAgent(opponent)) {
+			fprintf(stderr, "Error: The opponent must be a, b, c or (with --table) t.\n");
+			usage(argv[0]);
+			return 1;
+		}
 
 		initBoard();
 		char winner = ' ';
-		int turn = rand() % 2; // Randomly select starting player (0 or 1)
+		int turn = rngBelow(&rng, 2); // Randomly select starting player (0 or 1)
 		while (winner == ' ') {
 			displayBoard();
 			if (turn == 0) {
 				int row, col;
 				printf("Enter your move (row and column): ");
-				scanf("%d %d", &row, &col);
+				if (scanf("%d %d", &row, &col) != 2)
+					return 1; /* Input ended */
 				if (row >= 0 && row < 3 && col >= 0 && col < 3 && board[row][col] == ' ') {
 					board[row][col] = 'O'; // Human plays 'O'
 					turn = 1;
@@ -190,9 +536,17 @@ int main() {
 		} else {
 			printf("You win!\n");
 		}
+		if (options.format == FORMAT_CSV) {
+			fprintf(out, "opponent,winner\n%c,%c\n", opponent, winner);
+		} else if (options.format == FORMAT_JSON) {
+			fprintf(out, "{\"opponent\":\"%c\",\"winner\":\"%c\"}\n", opponent, winner);
+		}
 	} else {
 		printf("Invalid choice.\n");
 	}
 
+	if (out != stdout)
+		fclose(out);
+	telemetryClose();
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+    #define MAPFILE_NO_MMAP 1
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include "mapfile.h"
+
+void* mapFile(const char* path, size_t* size) {
+#ifdef MAPFILE_NO_MMAP
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+        return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void* data = length > 0 ? malloc((size_t)length) : NULL;
+    if (data != NULL && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = (size_t)length;
+    return data;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat info;
+    void* data = NULL;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+            data = NULL;
+        *size = (size_t)info.st_size;
+    }
+    close(fd); /* The mapping outlives the descriptor */
+    return data;
+#endif
+}
+
+void unmapFile(void* data, size_t size) {
+#ifdef MAPFILE_NO_MMAP
+    (void)size;
+    free(data);
+#else
+    munmap(data, size);
+#endif
+}
@@ -0,0 +1,13 @@
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <stddef.h>
+
+/*
+ * A whole file, read-only: mapped where the platform can, else read into
+ * memory. Returns NULL if the file is missing or empty.
+ */
+void* mapFile(const char* path, size_t* size);
+void unmapFile(void* data, size_t size);
+
+#endif // MAPFILE_H
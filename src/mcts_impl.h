@@ -0,0 +1,696 @@
+/*
+ * The MCTS core of the 3x3 agents. agentA.c and agentB.c each include
+ * this file once, after defining the policies that make the agent:
+ *
+ *   MCTS_AGENT              the agent's struct tag (AgentA, AgentB)
+ *   MCTS_LABEL              its name in messages ("A", "B")
+ *   MCTS_UCB_RULE           selection rule, see ucb.h
+ *   MCTS_EXPLORATION        default exploration constant
+ *   MCTS_REUSE_TREE         1: keep the subtree of the actual position between moves
+ *   MCTS_ROOT_MOVER(player) side to move at the root when player searches
+ *   MCTS_DESCEND_ON_EXPAND  1: play out from one random new child, 0: from the leaf
+ *   MCTS_UNVISITED_RATE(proven, player)
+ *                           observed rate of a root child with no visits when
+ *                           choosing the move (NAN: never chosen)
+ *
+ * and the rollout policy, as a Rollout type with
+ *
+ *   int  rolloutBatch(const SearchConfig* config)   playouts per leaf
+ *   void rolloutInit(Rollout* rollout, const SearchConfig* config, Rng* rng)
+ *   int  rolloutHalfWins(Rollout* rollout, Rng* rng, const BitBoard* state,
+ *                        int playouts, char player)
+ *
+ * Every definition here is static, so each agent compiles to its own
+ * search loop with the policies inlined. Nodes live in a Tree (tree.h);
+ * the statistics of a move are on the edge into its node.
+ */
+
+#define MCTS_ITERATIONS 5000 /* Default budget; SearchConfig can override it */
+#define VIRTUAL_LOSS 1 /* Losses charged per playout in flight through a node */
+#define CLOCK_CHECK_INTERVAL 64 /* Check the deadline every 64 playouts */
+
+/* Phase timers run on one iteration in PHASE_SAMPLE; build with -DPHASE_TIMERS=0 to drop them */
+#ifndef PHASE_TIMERS
+#define PHASE_TIMERS 1
+#endif
+#define PHASE_SAMPLE 64
+
+/* Longest selection path: the root plus one node per cell */
+#define MAX_PATH (BB_CELLS + 1)
+
+/* Node statistics are shared between search threads */
+#define LOAD(field) atomic_load_explicit(&(field), memory_order_relaxed)
+#define ADD(field, n) atomic_fetch_add_explicit(&(field), (n), memory_order_relaxed)
+/* Plain read-modify-write for trees no other thread touches */
+#define BUMP(field, n, shared) ((shared) ? (void)ADD(field, n) : \
+    atomic_store_explicit(&(field), LOAD(field) + (n), memory_order_relaxed))
+
+/*
+ * One step of a selection path. Nodes are shared through the
+ * transposition table and store no board (see tree.h), so the path
+ * records how a playout reached each node and the positions on the way.
+ */
+typedef struct {
+    TreeNode* node;
+    int slot;       /* Edge taken from the previous step's node */
+    BitBoard state; /* Position of the node */
+} PathStep;
+
+/* Work for one search thread */
+typedef struct {
+    Tree* tree;
+    NodeId root;
+    BitBoard rootState;
+    pthread_mutex_t* lock; /* Guards the tree's storage when it is shared, else NULL */
+    atomic_int* budget;    /* Iterations left on this tree */
+    Rng rng;               /* This thread's random stream */
+    int batch;             /* Playouts per leaf */
+    Rollout rollout;
+    double exploration;
+    double deadline;       /* timeNowMs() to stop at, 0 for none */
+    double start;          /* timeNowMs() when the search began */
+    int startVisits;       /* Root visits inherited from earlier searches */
+    int earlyStop;         /* Stop once the best root move is settled */
+    int settled;           /* Set by the thread that stopped early */
+    char player;
+
+    /* Telemetry of this thread */
+    int iterations;
+    int maxDepth;
+    int sampled;                   /* Iterations the phase timers ran on */
+    double phaseMs[SEARCH_PHASES]; /* Time of the sampled iterations */
+    double loopMs;                 /* Time in the iteration loop, which the estimates may not exceed */
+    double clockMs;                /* Cost of a timeNowMs() call, taken off every phase */
+} SearchTask;
+
+/*
+ * Search state kept by one caller. The tree of the last search is
+ * trees[activeArena], stored in arenas[activeArena] and indexed by
+ * nodeTable. When the next call finds the actual position, or one of its
+ * rotations or reflections (symmetry.h), in the table, the nodes
+ * reachable from it are copied into the other tree, turned back onto the
+ * actual board, and the old arena, holding only the unreachable
+ * siblings, is reset in one step.
+ */
+struct MCTS_AGENT {
+    Arena arenas[2];
+    Tree trees[2];
+    int activeArena;
+    TransTable* nodeTable;
+    char treeMover; /* Side to move at the root of the kept tree, ' ' for none */
+
+    /* Private trees of the extra workers in root-parallel mode */
+    Arena workerArenas[MAX_SEARCH_THREADS];
+    TransTable* workerTables[MAX_SEARCH_THREADS];
+    Tree workerTrees[MAX_SEARCH_THREADS];
+};
+
+static NodeId reuseTree(struct MCTS_AGENT* agent, const BitBoard* position, const Table* solved);
+static NodeId copySubtree(Tree* tree, const Tree* from, NodeId id, const BitBoard* state, int symmetry);
+static void searchWorker(void* arg);
+static int shouldStop(SearchTask* task);
+static double phaseLap(SearchTask* task, int phase, double mark);
+static void mergeRoots(Tree* tree, TreeNode* root, SearchTask* tasks, int count);
+static PathStep* descend(const Tree* tree, PathStep* path, int* length, int slot, int virtualLoss);
+static int expandNode(SearchTask* task, TreeNode* node, const BitBoard* state);
+static void backpropagate(const SearchTask* task, const PathStep* path, int length, int playouts,
+                          int halfWins);
+static int updateProof(const Tree* tree, TreeNode* node, char mover);
+
+static struct MCTS_AGENT* mctsCreate(void) {
+    struct MCTS_AGENT* agent = (struct MCTS_AGENT*)calloc(1, sizeof(struct MCTS_AGENT));
+    if (agent == NULL)
+        return NULL;
+    agent->nodeTable = (TransTable*)calloc(1, sizeof(TransTable));
+    if (agent->nodeTable == NULL) {
+        free(agent);
+        return NULL;
+    }
+    agent->treeMover = ' ';
+    return agent;
+}
+
+static void mctsDestroy(struct MCTS_AGENT* agent) {
+    if (agent == NULL)
+        return;
+    arenaDestroy(&agent->arenas[0]);
+    arenaDestroy(&agent->arenas[1]);
+    free(agent->nodeTable);
+    for (int t = 0; t < MAX_SEARCH_THREADS; t++) {
+        arenaDestroy(&agent->workerArenas[t]);
+        free(agent->workerTables[t]);
+    }
+    free(agent);
+}
+
+/* The root position for a search on state */
+static BitBoard rootPosition(const GameState* state) {
+    return bbFromBoard((char (*)[3])state->cells, MCTS_ROOT_MOVER(state->toMove));
+}
+
+static int mctsSearch(struct MCTS_AGENT* agent, const GameState* state, const SearchConfig* config,
+                      SearchResult* result) {
+    char player = state->toMove;
+    BitBoard position = rootPosition(state);
+    if (bbIsTerminal(&position))
+        return -1;
+
+    double start = timeNowMs();
+    int iterations = config->iterations > 0 ? config->iterations : MCTS_ITERATIONS;
+    if (config->iterations <= 0 && config->timeBudgetMs > 0)
+        iterations = INT_MAX; /* Only the clock limits the search */
+    NodeId rootId = reuseTree(agent, &position, config->table);
+    if (rootId == TT_NONE)
+        return -1; /* Out of memory */
+    Tree* mainTree = &agent->trees[agent->activeArena];
+    TreeNode* root = treeNode(mainTree, rootId);
+    int reusedVisits = LOAD(root->visits);
+
+    int threads = parallelThreads(config->threads);
+    int independent = threads > 1 && config->rootParallel;
+    SearchTask tasks[MAX_SEARCH_THREADS];
+    atomic_int budgets[MAX_SEARCH_THREADS];
+    pthread_mutex_t lock;
+    pthread_mutex_init(&lock, NULL);
+    int outOfMemory = 0;
+
+    for (int t = 0; t < threads; t++) {
+        tasks[t].tree = mainTree;
+        tasks[t].root = rootId;
+        tasks[t].rootState = position;
+        tasks[t].lock = threads > 1 ? &lock : NULL;
+        tasks[t].budget = &budgets[0];
+        tasks[t].exploration = config->exploration > 0 ? config->exploration : MCTS_EXPLORATION;
+        tasks[t].deadline = config->timeBudgetMs > 0 ? start + config->timeBudgetMs : 0;
+        tasks[t].start = start;
+        tasks[t].startVisits = reusedVisits;
+        /* Private trees see only part of the statistics, so they run their full share */
+        tasks[t].earlyStop = !config->exhaustive && !independent;
+        tasks[t].settled = 0;
+        tasks[t].player = player;
+        tasks[t].iterations = 0;
+        tasks[t].maxDepth = 0;
+        tasks[t].sampled = 0;
+        for (int p = 0; p < SEARCH_PHASES; p++)
+            tasks[t].phaseMs[p] = 0;
+        tasks[t].loopMs = 0;
+        tasks[t].clockMs = PHASE_TIMERS ? timeNowCostMs() : 0;
+        rngInit(&tasks[t].rng, config->seed ? config->seed + t : rngStreamSeed());
+        tasks[t].batch = rolloutBatch(config);
+        rolloutInit(&tasks[t].rollout, config, &tasks[t].rng);
+        if (independent) {
+            /* Root parallelism: split the budget over independent trees */
+            atomic_init(&budgets[t], iterations / threads + (t < iterations % threads));
+            tasks[t].lock = NULL;
+            tasks[t].budget = &budgets[t];
+            if (t > 0) {
+                if (agent->workerTables[t] == NULL)
+                    agent->workerTables[t] = (TransTable*)calloc(1, sizeof(TransTable));
+                arenaReset(&agent->workerArenas[t]);
+                ttClear(agent->workerTables[t]);
+                Tree* tree = &agent->workerTrees[t];
+                treeInit(tree, &agent->workerArenas[t], agent->workerTables[t], config->table);
+                tasks[t].tree = tree;
+                tasks[t].root = treeAdd(tree, &position);
+                outOfMemory |= tasks[t].root == TT_NONE;
+            }
+        }
+    }
+    if (outOfMemory) {
+        pthread_mutex_destroy(&lock);
+        return -1;
+    }
+    if (!independent)
+        atomic_init(&budgets[0], iterations);
+
+    parallelRun(searchWorker, tasks, sizeof(SearchTask), threads);
+    pthread_mutex_destroy(&lock);
+
+    if (independent)
+        mergeRoots(mainTree, root, tasks + 1, threads - 1);
+
+    /* Choosing the best move */
+    int bestSlot = -1;
+    double bestWinRate = -1.0, bestObserved = -1.0;
+    int childCount = LOAD(root->childCount);
+    Children children = treeChildren(root, childCount);
+    for (int i = 0; i < childCount; i++) {
+        int visits = LOAD(children.visits[i]);
+        char proven = LOAD(treeNode(mainTree, children.nodes[i])->proven);
+        double observed = visits > 0 ? LOAD(children.halfWins[i]) / (2.0 * visits) :
+                                       MCTS_UNVISITED_RATE(proven, player);
+        double winRate = proven != ' ' ? solverWinRate(proven, player) : observed;
+        /* Between equal proven values, the better playout record wins against weaker play */
+        if (winRate > bestWinRate || (winRate == bestWinRate && observed > bestObserved)) {
+            bestWinRate = winRate;
+            bestObserved = observed;
+            bestSlot = i;
+        }
+    }
+    int bestCell = bestSlot >= 0 ? children.moves[bestSlot] : -1;
+
+    int iterationsDone = LOAD(root->visits) - reusedVisits;
+    double elapsedMs = timeNowMs() - start;
+    if (config->verbose) {
+        printf("Agent " MCTS_LABEL " ran %d iterations in %.1f ms.\n", iterationsDone, elapsedMs);
+        if (reusedVisits > 0) {
+            printf("Agent " MCTS_LABEL " reused a subtree with %d visits.\n", reusedVisits);
+        }
+        char proven = LOAD(root->proven);
+        if (proven != ' ') {
+            printf("Agent " MCTS_LABEL " proved the position a %s.\n",
+                   proven == 'D' ? "draw" : proven == player ? "win" : "loss");
+        }
+        printf("Agent " MCTS_LABEL " is considering %d possible moves (%d positions in its tree).\n",
+               childCount, agent->nodeTable->count);
+        if (bestSlot >= 0) {
+            printf("Agent " MCTS_LABEL " selects move at row %d, column %d with win rate %.2f%%.\n",
+                   bestCell / 3, bestCell % 3, bestWinRate * 100);
+        } else {
+            printf("Agent " MCTS_LABEL " failed to select a best move, choosing randomly.\n");
+        }
+    }
+
+    if (bestSlot < 0) {
+        /* Fallback to random move */
+        unsigned empty = bbEmpty(&position);
+        bestCell = bbNth(empty, rngBelow(&tasks[0].rng, bbCount(empty)));
+        bestWinRate = 0.0;
+    }
+
+    result->row = bestCell / 3;
+    result->col = bestCell % 3;
+    result->winRate = bestWinRate;
+    result->iterations = iterationsDone;
+    result->candidates = childCount;
+    result->nodes = agent->nodeTable->count;
+    result->nodeBytes = mainTree->arena->bytesInUse;
+    for (int t = 1; independent && t < threads; t++)
+        result->nodeBytes += agent->workerArenas[t].bytesInUse;
+    result->reusedVisits = reusedVisits;
+    result->elapsedMs = elapsedMs;
+    result->stoppedEarly = 0;
+    result->maxDepth = 0;
+    for (int p = 0; p < SEARCH_PHASES; p++)
+        result->phaseMs[p] = 0;
+    for (int t = 0; t < threads; t++) {
+        result->stoppedEarly |= tasks[t].settled;
+        if (tasks[t].maxDepth > result->maxDepth)
+            result->maxDepth = tasks[t].maxDepth;
+        /* Each thread's sample stands for all of its iterations, within the time it spent on them */
+        double sampledMs = 0;
+        for (int p = 0; p < SEARCH_PHASES; p++)
+            sampledMs += tasks[t].phaseMs[p];
+        if (tasks[t].sampled == 0 || sampledMs <= 0)
+            continue;
+        double scale = (double)tasks[t].iterations / tasks[t].sampled;
+        if (sampledMs * scale > tasks[t].loopMs)
+            scale = tasks[t].loopMs / sampledMs;
+        for (int p = 0; p < SEARCH_PHASES; p++)
+            result->phaseMs[p] += tasks[t].phaseMs[p] * scale;
+    }
+    for (int cell = 0; cell < BB_CELLS; cell++)
+        result->rootVisits[cell] = 0;
+    for (int i = 0; i < childCount; i++)
+        result->rootVisits[children.moves[i]] = LOAD(children.visits[i]);
+
+    /* With reuse, the next call looks up the position it is given in this tree */
+    agent->treeMover = MCTS_REUSE_TREE ? position.toMove : ' ';
+    return 0;
+}
+
+/* A private tree for the bench kernels, rooted the way mctsSearch() roots it */
+static NodeId benchTree(Tree* tree, const GameState* state, BitBoard* position) {
+    *position = rootPosition(state);
+    treeInit(tree, (Arena*)calloc(1, sizeof(Arena)), (TransTable*)calloc(1, sizeof(TransTable)), NULL);
+    return treeAdd(tree, position);
+}
+
+static void benchRelease(Tree* tree) {
+    arenaDestroy(tree->arena);
+    free(tree->arena);
+    free(tree->table);
+}
+
+static int mctsBenchSelect(const GameState* state, int count) {
+    Tree tree;
+    BitBoard position;
+    TreeNode* root = treeNode(&tree, benchTree(&tree, state, &position));
+    SearchTask task = { 0 };
+    task.tree = &tree;
+    expandNode(&task, root, &position);
+
+    /* Uneven statistics so every child takes part in the comparison */
+    int childCount = LOAD(root->childCount);
+    Children children = treeChildren(root, childCount);
+    for (int i = 0; i < childCount; i++) {
+        atomic_store(&children.visits[i], 10 + 7 * i);
+        atomic_store(&children.halfWins[i], 5 + 11 * i);
+        ADD(root->visits, 10 + 7 * i);
+    }
+    int checksum = 0;
+    for (int i = 0; i < count; i++)
+        checksum += children.moves[ucbSelect(&children, childCount, LOAD(root->visits),
+                                             MCTS_EXPLORATION, MCTS_UCB_RULE)];
+    benchRelease(&tree);
+    return checksum;
+}
+
+static int mctsBenchNodes(const GameState* state, int count) {
+    Tree tree;
+    BitBoard position;
+    benchTree(&tree, state, &position);
+    int checksum = 0;
+    for (int i = 0; i < count; i++) {
+        if (tree.count == TREE_MAX_CHUNKS * TREE_CHUNK) {
+            /* Full: start over in the same storage */
+            arenaReset(tree.arena);
+            ttClear(tree.table);
+            treeInit(&tree, tree.arena, tree.table, NULL);
+        }
+        checksum += (int)treeAdd(&tree, &position);
+    }
+    benchRelease(&tree);
+    return checksum;
+}
+
+static NodeId reuseTree(struct MCTS_AGENT* agent, const BitBoard* position, const Table* solved) {
+    /*
+     * The tree expands one move per set of symmetric ones, so the actual
+     * position may only be there as one of its images
+     */
+    NodeId match = TT_NONE;
+    int symmetry = 0;
+    for (int s = 0; agent->treeMover == position->toMove && s < SYM_COUNT && match == TT_NONE; s++) {
+        BitBoard image = { (unsigned short)symMap(position->x, s), (unsigned short)symMap(position->o, s),
+                           position->toMove };
+        match = ttLookup(agent->nodeTable, bbIndex(&image));
+        symmetry = s;
+    }
+    agent->treeMover = ' ';
+    ttClear(agent->nodeTable);
+    if (match == TT_NONE) {
+        /* Nothing to keep: start over in the active arena */
+        Arena* arena = &agent->arenas[agent->activeArena];
+        arenaReset(arena);
+        treeInit(&agent->trees[agent->activeArena], arena, agent->nodeTable, solved);
+        return treeAdd(&agent->trees[agent->activeArena], position);
+    }
+
+    /* Move the surviving subgraph over, then drop everything else at once */
+    int previousArena = agent->activeArena;
+    agent->activeArena ^= 1;
+    Tree* tree = &agent->trees[agent->activeArena];
+    arenaReset(&agent->arenas[agent->activeArena]);
+    treeInit(tree, &agent->arenas[agent->activeArena], agent->nodeTable, solved);
+    NodeId root = copySubtree(tree, &agent->trees[previousArena], match, position, symmetry);
+    arenaReset(&agent->arenas[previousArena]);
+    return root;
+}
+
+/* Copies the node at the image of state under symmetry, turning its moves back onto state */
+static NodeId copySubtree(Tree* tree, const Tree* from, NodeId id, const BitBoard* state, int symmetry) {
+    /* Nodes shared by several parents are copied once */
+    NodeId copyId = ttLookup(tree->table, bbIndex(state));
+    if (copyId != TT_NONE)
+        return copyId;
+    const TreeNode* node = treeNode(from, id);
+    copyId = treeAdd(tree, state);
+    if (copyId == TT_NONE)
+        return TT_NONE;
+    TreeNode* copy = treeNode(tree, copyId);
+    atomic_init(&copy->visits, LOAD(node->visits));
+    atomic_init(&copy->expanded, LOAD(node->expanded));
+    atomic_init(&copy->proven, LOAD(node->proven));
+    int count = LOAD(node->childCount);
+    if (count == 0)
+        return copyId;
+    Children source = treeChildren(node, count);
+    Children target = treeAllocChildren(tree, copy, count);
+    for (int i = 0; i < count; i++) {
+        BitBoard next = *state;
+        target.moves[i] = (unsigned char)symInverseCell(source.moves[i], symmetry);
+        bbPlay(&next, target.moves[i]);
+        target.nodes[i] = copy->block != NULL ?
+            copySubtree(tree, from, source.nodes[i], &next, symmetry) : TT_NONE;
+        if (target.nodes[i] == TT_NONE) {
+            /* Out of memory: keep the copy as a leaf that may be expanded again */
+            atomic_init(&copy->expanded, 0);
+            return copyId;
+        }
+        atomic_init(&target.visits[i], LOAD(source.visits[i]));
+        atomic_init(&target.halfWins[i], LOAD(source.halfWins[i]));
+        atomic_init(&target.proven[i], LOAD(source.proven[i]));
+    }
+    atomic_init(&copy->childCount, count);
+    return copyId;
+}
+
+static void searchWorker(void* arg) {
+    SearchTask* task = (SearchTask*)arg;
+    Tree* tree = task->tree;
+    TreeNode* root = treeNode(tree, task->root);
+    /* Virtual loss only matters when other threads share the tree */
+    int virtualLoss = task->lock != NULL ? VIRTUAL_LOSS : 0;
+
+    int done = 0, nextCheck = 0;
+    double loopStart = PHASE_TIMERS ? timeNowMs() : 0;
+    int left;
+    while ((left = atomic_fetch_sub_explicit(task->budget, task->batch, memory_order_relaxed)) > 0) {
+        if (done >= nextCheck) {
+            if (shouldStop(task))
+                break;
+            nextCheck += CLOCK_CHECK_INTERVAL;
+        }
+        /* A proven root needs no more playouts once its moves are there to choose from */
+        if (task->earlyStop && LOAD(root->proven) != ' ' &&
+            atomic_load_explicit(&root->childCount, memory_order_acquire) > 0) {
+            atomic_store_explicit(task->budget, 0, memory_order_relaxed);
+            task->settled = 1;
+            break;
+        }
+        int playouts = left < task->batch ? left : task->batch;
+        done += playouts;
+        /* Not the first iteration, which pays for cold caches and fresh slabs */
+        task->iterations++;
+        int timed = PHASE_TIMERS && task->iterations % PHASE_SAMPLE == 0;
+        double mark = timed ? timeNowMs() : 0;
+
+        PathStep path[MAX_PATH];
+        int length = 1;
+        PathStep* leaf = &path[0];
+        leaf->node = root;
+        leaf->slot = -1;
+        leaf->state = task->rootState;
+
+        /* Selection, around proven subtrees */
+        int childCount;
+        while ((childCount = atomic_load_explicit(&leaf->node->childCount, memory_order_acquire)) > 0) {
+            Children children = treeChildren(leaf->node, childCount);
+            int slot = ucbSelect(&children, childCount, LOAD(leaf->node->visits), task->exploration,
+                                 MCTS_UCB_RULE);
+            if (slot < 0) {
+                /* Every child is proven, so this node is too */
+                updateProof(tree, leaf->node, leaf->state.toMove);
+                break;
+            }
+            leaf = descend(tree, path, &length, slot, virtualLoss);
+            if (LOAD(leaf->node->proven) != ' ')
+                break;
+        }
+        if (timed)
+            mark = phaseLap(task, PHASE_SELECT, mark);
+
+        /* Expansion; a root the table proves is still expanded, for its moves' values */
+        if ((LOAD(leaf->node->proven) == ' ' || length == 1) &&
+            expandNode(task, leaf->node, &leaf->state) &&
+            MCTS_DESCEND_ON_EXPAND) {
+            childCount = LOAD(leaf->node->childCount);
+            if (childCount > 0)
+                leaf = descend(tree, path, &length, rngBelow(&task->rng, childCount), virtualLoss);
+        }
+        if (length - 1 > task->maxDepth)
+            task->maxDepth = length - 1;
+        if (timed)
+            mark = phaseLap(task, PHASE_EXPAND, mark);
+
+        /* Simulation, unless the result is already proven */
+        int halfWins;
+        char proven = LOAD(leaf->node->proven);
+        if (proven != ' ') {
+            halfWins = playouts * solverHalfWins(proven, task->player);
+        } else {
+            halfWins = rolloutHalfWins(&task->rollout, &task->rng, &leaf->state, playouts, task->player);
+        }
+        if (timed)
+            mark = phaseLap(task, PHASE_SIMULATE, mark);
+
+        /* Backpropagation along the path actually taken */
+        backpropagate(task, path, length, playouts, halfWins);
+        if (timed) {
+            phaseLap(task, PHASE_BACKUP, mark);
+            task->sampled++;
+        }
+    }
+    if (PHASE_TIMERS)
+        task->loopMs = timeNowMs() - loopStart;
+}
+
+/* Charges the time since mark, less the clock call that measured it, to phase; returns the new mark */
+static double phaseLap(SearchTask* task, int phase, double mark) {
+    double now = timeNowMs();
+    double lap = now - mark - task->clockMs;
+    task->phaseMs[phase] += lap > 0 ? lap : 0;
+    return now;
+}
+
+/* Appends the child in slot of the path's last node, replaying its move */
+static PathStep* descend(const Tree* tree, PathStep* path, int* length, int slot, int virtualLoss) {
+    const PathStep* parent = &path[*length - 1];
+    Children children = treeChildren(parent->node, LOAD(parent->node->childCount));
+    if (virtualLoss)
+        ADD(children.inFlight[slot], virtualLoss);
+    PathStep* step = &path[(*length)++];
+    step->node = treeNode(tree, children.nodes[slot]);
+    step->slot = slot;
+    /* Proven since the block last looked, say through another parent: selection skips it from now on */
+    char proven = LOAD(step->node->proven);
+    if (proven != ' ')
+        atomic_store_explicit(&children.proven[slot], proven, memory_order_relaxed);
+    step->state = parent->state;
+    bbPlay(&step->state, children.moves[slot]);
+    return step;
+}
+
+/* Called every batch of iterations; a settled search also ends the other threads on the tree */
+static int shouldStop(SearchTask* task) {
+    if (task->deadline <= 0 && !task->earlyStop)
+        return 0;
+    double now = timeNowMs();
+    if (task->deadline > 0 && now >= task->deadline)
+        return 1;
+    if (!task->earlyStop)
+        return 0;
+
+    TreeNode* root = treeNode(task->tree, task->root);
+    AnytimeChild children[BB_CELLS];
+    int childCount = atomic_load_explicit(&root->childCount, memory_order_acquire);
+    /* Until the count is published, another thread may still be writing root->block */
+    if (childCount == 0)
+        return 0;
+    Children edges = treeChildren(root, childCount);
+    for (int i = 0; i < childCount; i++) {
+        children[i].halfWins = LOAD(edges.halfWins[i]);
+        children[i].visits = LOAD(edges.visits[i]);
+        children[i].fixed = 0;
+        char proven = LOAD(treeNode(task->tree, edges.nodes[i])->proven);
+        if (proven != ' ') {
+            /* Counted at its exact value, which no playout changes */
+            children[i].halfWins = solverHalfWins(proven, task->player);
+            children[i].visits = 1;
+            children[i].fixed = 1;
+        }
+    }
+    double remaining = anytimeRemaining(LOAD(*task->budget),
+        LOAD(root->visits) - task->startVisits, task->start, now, task->deadline);
+    if (!anytimeSettled(children, childCount, remaining))
+        return 0;
+    atomic_store_explicit(task->budget, 0, memory_order_relaxed);
+    task->settled = 1;
+    return 1;
+}
+
+static void mergeRoots(Tree* tree, TreeNode* root, SearchTask* tasks, int count) {
+    int rootChildren = LOAD(root->childCount);
+    Children targets = treeChildren(root, rootChildren);
+    for (int t = 0; t < count; t++) {
+        TreeNode* other = treeNode(tasks[t].tree, tasks[t].root);
+        int otherChildren = LOAD(other->childCount);
+        Children sources = treeChildren(other, otherChildren);
+        for (int i = 0; i < otherChildren; i++) {
+            for (int j = 0; j < rootChildren; j++) {
+                if (targets.moves[j] == sources.moves[i]) {
+                    ADD(targets.visits[j], LOAD(sources.visits[i]));
+                    ADD(targets.halfWins[j], LOAD(sources.halfWins[i]));
+                    char proven = LOAD(treeNode(tasks[t].tree, sources.nodes[i])->proven);
+                    if (proven != ' ')
+                        atomic_store_explicit(&treeNode(tree, targets.nodes[j])->proven, proven,
+                                              memory_order_relaxed);
+                    break;
+                }
+            }
+        }
+        ADD(root->visits, LOAD(other->visits));
+    }
+}
+
+static int expandNode(SearchTask* task, TreeNode* node, const BitBoard* state) {
+    /* Only one thread expands a node; the others play out from the leaf */
+    char expected = 0;
+    if (!atomic_compare_exchange_strong(&node->expanded, &expected, 1))
+        return 0;
+
+    if (task->lock)
+        pthread_mutex_lock(task->lock);
+    /* One child per set of symmetric moves; transpositions share one node */
+    int expanded = treeExpand(task->tree, node, state, symDistinctMoves(state));
+    if (task->lock)
+        pthread_mutex_unlock(task->lock);
+    /* Out of memory, the node stays a leaf for the rest of the search */
+    return expanded;
+}
+
+static void backpropagate(const SearchTask* task, const PathStep* path, int length, int playouts,
+                          int halfWins) {
+    int shared = task->lock != NULL;
+    int proving = 1; /* Every node below is proven */
+    /*
+     * Walk the selection path rather than parent links: a shared node is
+     * updated once per playout that passes through it, whichever parent
+     * the playout came from.
+     */
+    for (int i = length - 1; i >= 0; i--) {
+        const PathStep* step = &path[i];
+        BUMP(step->node->visits, playouts, shared);
+        if (proving)
+            proving = updateProof(task->tree, step->node, step->state.toMove);
+
+        /* The statistics live on the edge into the node; the root has none */
+        if (i == 0)
+            break;
+        const TreeNode* parent = path[i - 1].node;
+        Children edges = treeChildren(parent, LOAD(parent->childCount));
+        BUMP(edges.visits[step->slot], playouts, shared);
+        /* No wins added for a loss */
+        if (halfWins > 0) {
+            BUMP(edges.halfWins[step->slot], halfWins, shared);
+        }
+        if (shared) {
+            ADD(edges.inFlight[step->slot], -VIRTUAL_LOSS);
+        }
+    }
+}
+
+/*
+ * Proves node from its children where it can; returns 1 once its value is
+ * known. The children's values are copied into the block on the way, so
+ * selection also skips children proven through another parent.
+ */
+static int updateProof(const Tree* tree, TreeNode* node, char mover) {
+    if (LOAD(node->proven) != ' ')
+        return 1;
+    int count = atomic_load_explicit(&node->childCount, memory_order_acquire);
+    if (count == 0)
+        return 0;
+    Children children = treeChildren(node, count);
+    char values[BB_CELLS];
+    for (int i = 0; i < count; i++) {
+        values[i] = LOAD(treeNode(tree, children.nodes[i])->proven);
+        atomic_store_explicit(&children.proven[i], values[i], memory_order_relaxed);
+    }
+    char value = solverValue(mover, values, count);
+    if (value == ' ')
+        return 0;
+    atomic_store_explicit(&node->proven, value, memory_order_relaxed);
+    return 1;
+}
@@ -0,0 +1,366 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+#include "arena.h"
+#include "rng.h"
+#include "timing.h"
+#include "anytime.h"
+#include "ucb.h"
+#include "mnk.h"
+
+/* Same defaults as the 3x3 agents */
+#define MNK_ITERATIONS 5000
+#define CLOCK_CHECK_MASK 63 /* Check the deadline every 64 iterations */
+
+/*
+ * Search node. The position is not stored: it is rebuilt by replaying
+ * the moves from the root, and the children of a node are allocated in
+ * one block sized to the empty cells when it is expanded.
+ */
+typedef struct MnkNode {
+    int visits;
+    int halfWins;             /* Two per win and one per draw for the searching player */
+    short move;               /* Cell played to reach this node */
+    short childCount;         /* 0 until expanded */
+    char result;              /* ' ' while the game goes on, else 'X', 'O' or 'D' */
+    struct MnkNode* children;
+} MnkNode;
+
+/* State of one search shared by every board size */
+typedef struct {
+    Arena* arena;
+    MnkNode* root;
+    Rng rng;
+    double exploration;
+    double start;
+    double deadline;  /* timeNowMs() to stop at, 0 for none */
+    int iterations;
+    int nodes;
+    int maxDepth;     /* Longest path to a playout */
+    int earlyStop;
+    int settled;
+    int verbose;
+    char agent;
+    char player;
+} MnkSearch;
+
+/* Rows, columns and the two diagonals */
+static const int mnkDirections[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+
+static inline int mnkCount(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(mask);
+#else
+    int n = 0;
+    for (; mask; mask &= mask - 1)
+        n++;
+    return n;
+#endif
+}
+
+/* Index of the lowest set bit; mask must be non-zero */
+static inline int mnkFirst(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(mask);
+#else
+    int bit = 0;
+    while (!(mask & 1u)) {
+        mask >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static void mnkInitNode(MnkNode* node, int move, char result) {
+    node->visits = 0;
+    node->halfWins = 0;
+    node->move = (short)move;
+    node->childCount = 0;
+    node->result = result;
+    node->children = NULL;
+}
+
+/*
+ * Agent A's fallback order: outwards from the centre ring by ring, corners
+ * of a ring before its edges. On 3x3 this is the centre, the corners and
+ * then the edges, as in agentA.c.
+ */
+static void mnkCentreOrder(short* order, int rows, int cols) {
+    int cells = rows * cols;
+    int keys[MNK_MAX_CELLS];
+    for (int cell = 0; cell < cells; cell++) {
+        /* Doubled distances from the centre, exact for even sizes too */
+        int dr = abs(2 * (cell / cols) - (rows - 1));
+        int dc = abs(2 * (cell % cols) - (cols - 1));
+        int ring = dr > dc ? dr : dc;
+        keys[cell] = (ring * 4 * MNK_MAX_CELLS - (dr + dc)) * MNK_MAX_CELLS + cell;
+    }
+    /* Insertion sort by key; stable and small enough */
+    for (int i = 0; i < cells; i++) {
+        int j = i;
+        while (j > 0 && keys[order[j - 1]] > keys[i]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (short)i;
+    }
+}
+
+/* Returns -1 when the arena cannot hold the root */
+static int mnkBeginSearch(MnkSearch* search, Arena* arena, char agent, char player,
+                          const SearchConfig* config) {
+    arenaReset(arena);
+    search->arena = arena;
+    search->root = (MnkNode*)arenaAlloc(arena, sizeof(MnkNode));
+    if (search->root == NULL)
+        return -1;
+    mnkInitNode(search->root, -1, ' ');
+    rngInit(&search->rng, config->seed ? config->seed : rngStreamSeed());
+    search->exploration = config->exploration > 0 ? config->exploration :
+                          (agent == 'a' ? UCB_EXPLORATION_A : UCB_EXPLORATION_B);
+    search->start = timeNowMs();
+    search->deadline = config->timeBudgetMs > 0 ? search->start + config->timeBudgetMs : 0;
+    search->nodes = 1;
+    search->maxDepth = 0;
+    search->iterations = config->iterations > 0 ? config->iterations : MNK_ITERATIONS;
+    if (config->iterations <= 0 && config->timeBudgetMs > 0)
+        search->iterations = INT_MAX; /* Only the clock limits the search */
+    search->earlyStop = !config->exhaustive;
+    search->settled = 0;
+    search->verbose = config->verbose;
+    search->agent = agent;
+    search->player = player;
+    return 0;
+}
+
+/* Called every batch of iterations, like the 3x3 agents' stopping rule */
+static int mnkShouldStop(MnkSearch* search, int iteration) {
+    if (search->deadline <= 0 && !search->earlyStop)
+        return 0;
+    double now = timeNowMs();
+    if (search->deadline > 0 && now >= search->deadline)
+        return 1;
+    if (!search->earlyStop)
+        return 0;
+
+    MnkNode* root = search->root;
+    AnytimeChild children[MNK_MAX_CELLS];
+    for (int i = 0; i < root->childCount; i++) {
+        children[i].halfWins = root->children[i].halfWins;
+        children[i].visits = root->children[i].visits;
+        children[i].fixed = root->children[i].result != ' ';
+    }
+    double remaining = anytimeRemaining(search->iterations - iteration, iteration,
+                                        search->start, now, search->deadline);
+    search->settled = anytimeSettled(children, root->childCount, remaining);
+    return search->settled;
+}
+
+/* UCB1 as agent A (unvisited children first) or agent B (smoothed counts) computes it */
+static MnkNode* mnkSelectChild(const MnkSearch* search, MnkNode* node) {
+    MnkNode* bestChild = NULL;
+    double bestValue = -DBL_MAX;
+    double logParent = search->agent == 'a' ? ucbLog(node->visits > 0 ? node->visits : 1) :
+                                              ucbLog(node->visits + 1);
+    for (int i = 0; i < node->childCount; i++) {
+        MnkNode* child = &node->children[i];
+        double value;
+        if (search->agent == 'a') {
+            if (child->visits == 0)
+                return child;
+            value = child->halfWins / (2.0 * child->visits) +
+                search->exploration * sqrt(logParent / child->visits);
+        } else {
+            double winRate = child->visits > 0 ? child->halfWins / (2.0 * child->visits) : 0.0;
+            value = winRate + search->exploration * sqrt(logParent / (child->visits + 1));
+        }
+        if (value > bestValue) {
+            bestValue = value;
+            bestChild = child;
+        }
+    }
+    return bestChild;
+}
+
+static void mnkBackpropagate(MnkNode** path, int length, char winner, char player) {
+    int halfWins = (winner == player) ? 2 : (winner == 'D') ? 1 : 0;
+    for (int i = 0; i < length; i++) {
+        path[i]->visits++;
+        path[i]->halfWins += halfWins;
+    }
+}
+
+/* Picks the root child with the best win rate and fills result */
+static void mnkEndSearch(MnkSearch* search, const MnkState* state, SearchResult* result) {
+    MnkNode* root = search->root;
+    MnkNode* bestChild = NULL;
+    double bestWinRate = -1.0;
+    for (int i = 0; i < root->childCount; i++) {
+        MnkNode* child = &root->children[i];
+        double winRate = child->visits > 0 ? child->halfWins / (2.0 * child->visits) : 0.0;
+        if (winRate > bestWinRate) {
+            bestWinRate = winRate;
+            bestChild = child;
+        }
+    }
+
+    int cell = bestChild ? bestChild->move : -1;
+    if (cell < 0) {
+        /* Fallback to random move */
+        int empty = 0;
+        for (int i = 0; i < state->rows * state->cols; i++)
+            empty += state->cells[i] == ' ';
+        int n = rngBelow(&search->rng, empty);
+        for (cell = 0; state->cells[cell] != ' ' || n-- > 0; cell++)
+            ;
+        bestWinRate = 0.0;
+    }
+
+    memset(result, 0, sizeof(*result));
+    result->row = cell / state->cols;
+    result->col = cell % state->cols;
+    result->winRate = bestWinRate;
+    result->iterations = root->visits;
+    result->candidates = root->childCount;
+    result->nodeBytes = search->arena->bytesInUse;
+    result->nodes = search->nodes;
+    result->elapsedMs = timeNowMs() - search->start;
+    result->stoppedEarly = search->settled;
+    result->maxDepth = search->maxDepth;
+
+    if (search->verbose) {
+        printf("Agent %c ran %d iterations in %.1f ms on %dx%d (k = %d).\n",
+               search->agent - 'a' + 'A', result->iterations, result->elapsedMs,
+               state->rows, state->cols, state->k);
+        printf("Agent %c selects move at row %d, column %d with win rate %.2f%%.\n",
+               search->agent - 'a' + 'A', result->row, result->col, bestWinRate * 100);
+    }
+}
+
+/* The specialisations; a new size is one more block here and a row in mnkSizes */
+#define MNK_ROWS 3
+#define MNK_COLS 3
+#define MNK_K 3
+#define MNK_NAME(name) mnk3x3x3_##name
+#include "mnk_impl.h"
+
+#define MNK_ROWS 7
+#define MNK_COLS 7
+#define MNK_K 4
+#define MNK_NAME(name) mnk7x7x4_##name
+#include "mnk_impl.h"
+
+#define MNK_ROWS 15
+#define MNK_COLS 15
+#define MNK_K 5
+#define MNK_NAME(name) mnk15x15x5_##name
+#include "mnk_impl.h"
+
+typedef int (*MnkSearchFn)(Arena* arena, char agent, const MnkState* state,
+                           const SearchConfig* config, SearchResult* result);
+
+static const struct {
+    int rows, cols, k;
+    MnkSearchFn search;
+} mnkSizes[] = {
+    { 3, 3, 3, mnk3x3x3_search },
+    { 7, 7, 4, mnk7x7x4_search },
+    { 15, 15, 5, mnk15x15x5_search },
+};
+#define MNK_SIZES (int)(sizeof(mnkSizes) / sizeof(mnkSizes[0]))
+
+static MnkSearchFn mnkFind(int rows, int cols, int k) {
+    for (int i = 0; i < MNK_SIZES; i++) {
+        if (mnkSizes[i].rows == rows && mnkSizes[i].cols == cols && mnkSizes[i].k == k)
+            return mnkSizes[i].search;
+    }
+    return NULL;
+}
+
+int mnkSupported(int rows, int cols, int k) {
+    return mnkFind(rows, cols, k) != NULL;
+}
+
+int mnkInit(MnkState* state, int rows, int cols, int k) {
+    if (!mnkSupported(rows, cols, k))
+        return -1;
+    state->rows = rows;
+    state->cols = cols;
+    state->k = k;
+    memset(state->cells, ' ', sizeof(state->cells));
+    state->toMove = 'X';
+    return 0;
+}
+
+/* Length of the row of player's marks through (row, col) along (dr, dc) */
+static int mnkRun(const MnkState* state, int row, int col, int dr, int dc, char player) {
+    int length = 1;
+    for (int r = row + dr, c = col + dc; r >= 0 && r < state->rows && c >= 0 && c < state->cols &&
+         state->cells[r * state->cols + c] == player; r += dr, c += dc)
+        length++;
+    for (int r = row - dr, c = col - dc; r >= 0 && r < state->rows && c >= 0 && c < state->cols &&
+         state->cells[r * state->cols + c] == player; r -= dr, c -= dc)
+        length++;
+    return length;
+}
+
+char mnkPlay(MnkState* state, int row, int col) {
+    char player = state->toMove;
+    state->cells[row * state->cols + col] = player;
+    state->toMove = (player == 'X') ? 'O' : 'X';
+    for (int d = 0; d < 4; d++) {
+        if (mnkRun(state, row, col, mnkDirections[d][0], mnkDirections[d][1], player) >= state->k)
+            return player;
+    }
+    return memchr(state->cells, ' ', state->rows * state->cols) ? ' ' : 'D';
+}
+
+char mnkWinner(const MnkState* state) {
+    int cells = state->rows * state->cols;
+    for (int cell = 0; cell < cells; cell++) {
+        char player = state->cells[cell];
+        if (player == ' ')
+            continue;
+        for (int d = 0; d < 4; d++) {
+            if (mnkRun(state, cell / state->cols, cell % state->cols,
+                       mnkDirections[d][0], mnkDirections[d][1], player) >= state->k)
+                return player;
+        }
+    }
+    return memchr(state->cells, ' ', cells) ? ' ' : 'D';
+}
+
+int mnkSearch(Arena* arena, char agent, const MnkState* state,
+              const SearchConfig* config, SearchResult* result) {
+    MnkSearchFn search = mnkFind(state->rows, state->cols, state->k);
+    if (search == NULL || mnkWinner(state) != ' ')
+        return -1;
+
+    if (agent == 'c') {
+        /* Pick uniformly among the empty cells */
+        Rng rng;
+        rngInit(&rng, config->seed ? config->seed : rngStreamSeed());
+        int cells = state->rows * state->cols, empty = 0, cell;
+        for (cell = 0; cell < cells; cell++)
+            empty += state->cells[cell] == ' ';
+        int n = rngBelow(&rng, empty);
+        for (cell = 0; state->cells[cell] != ' ' || n-- > 0; cell++)
+            ;
+        if (config->verbose) {
+            printf("Agent C is making a random move.\n");
+        }
+        memset(result, 0, sizeof(*result));
+        result->row = cell / state->cols;
+        result->col = cell % state->cols;
+        result->candidates = empty;
+        return 0;
+    }
+    if (agent != 'a' && agent != 'b')
+        return -1;
+    return search(arena, agent, state, config, result);
+}
@@ -0,0 +1,47 @@
+#ifndef MNK_H
+#define MNK_H
+
+#include "arena.h"
+#include "engine.h"
+
+/*
+ * m,n,k games: a board of m rows and n columns where k marks in a row
+ * (horizontally, vertically or diagonally) win. The agents search each
+ * supported size through its own compile-time specialisation of
+ * mnk_impl.h; the classic game keeps its 3x3 agents in agentA.c and
+ * agentB.c.
+ */
+
+#define MNK_MAX_CELLS 225 /* Largest supported board, 15x15 */
+
+typedef struct {
+    int rows, cols, k;
+    char cells[MNK_MAX_CELLS]; /* Row by row: ' ', 'X' or 'O' */
+    char toMove;
+} MnkState;
+
+/* Returns 1 if the agents have a specialisation for this size */
+int mnkSupported(int rows, int cols, int k);
+
+/* Empties the board with X to move; returns -1 for an unsupported size */
+int mnkInit(MnkState* state, int rows, int cols, int k);
+
+/* Places the mark of the side to move, passes the turn and returns the winner, ' ' while ongoing */
+char mnkPlay(MnkState* state, int row, int col);
+
+/* Winner of the position by scanning the whole board: 'X', 'O', 'D' or ' ' */
+char mnkWinner(const MnkState* state);
+
+/*
+ * Chooses a move for state->toMove with agent 'a', 'b' or 'c', like
+ * engineSearch(). Searches run on one thread with a fresh tree each move,
+ * so config->threads and config->rootParallel are ignored.
+ */
+int engineSearchMnk(Engine* engine, char agent, const MnkState* state,
+                    const SearchConfig* config, SearchResult* result);
+
+/* The search behind engineSearchMnk(), with node memory taken from arena */
+int mnkSearch(Arena* arena, char agent, const MnkState* state,
+              const SearchConfig* config, SearchResult* result);
+
+#endif // MNK_H
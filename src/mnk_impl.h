@@ -0,0 +1,261 @@
+/*
+ * One board size of the m,n,k search. mnk.c includes this file once per
+ * size with MNK_ROWS, MNK_COLS, MNK_K and MNK_NAME(name) defined; every
+ * definition is static and named through MNK_NAME, so the sizes share a
+ * translation unit and each gets loops with constant bounds. Only the
+ * board and the playouts depend on the size; nodes, selection and
+ * backpropagation live in mnk.c.
+ */
+
+#define MNK_CELLS (MNK_ROWS * MNK_COLS)
+#define MNK_WORDS ((MNK_CELLS + 63) / 64)
+#define MNK_LAST_WORD (MNK_CELLS % 64 ? (1ull << (MNK_CELLS % 64)) - 1 : ~0ull)
+
+/* One bit per cell for each side, in words of 64 cells */
+typedef struct {
+    uint64_t x[MNK_WORDS];
+    uint64_t o[MNK_WORDS];
+    int moves;
+    char toMove;
+} MNK_NAME(Board);
+
+static inline int MNK_NAME(has)(const uint64_t* mask, int cell) {
+    return (int)((mask[cell >> 6] >> (cell & 63)) & 1u);
+}
+
+static inline int MNK_NAME(isEmpty)(const MNK_NAME(Board)* board, int cell) {
+    return !MNK_NAME(has)(board->x, cell) && !MNK_NAME(has)(board->o, cell);
+}
+
+static inline const uint64_t* MNK_NAME(stones)(const MNK_NAME(Board)* board, char player) {
+    return (player == 'X') ? board->x : board->o;
+}
+
+/* Length of the row of stones through cell along (dr, dc), counting cell itself */
+static inline int MNK_NAME(run)(const uint64_t* mask, int cell, int dr, int dc) {
+    int row = cell / MNK_COLS, col = cell % MNK_COLS, length = 1;
+    for (int r = row + dr, c = col + dc;
+         r >= 0 && r < MNK_ROWS && c >= 0 && c < MNK_COLS && MNK_NAME(has)(mask, r * MNK_COLS + c);
+         r += dr, c += dc)
+        length++;
+    for (int r = row - dr, c = col - dc;
+         r >= 0 && r < MNK_ROWS && c >= 0 && c < MNK_COLS && MNK_NAME(has)(mask, r * MNK_COLS + c);
+         r -= dr, c -= dc)
+        length++;
+    return length;
+}
+
+/* Would a stone on cell complete k in a row? Only the lines through cell are looked at */
+static inline int MNK_NAME(wins)(const uint64_t* mask, int cell) {
+    for (int d = 0; d < 4; d++) {
+        if (MNK_NAME(run)(mask, cell, mnkDirections[d][0], mnkDirections[d][1]) >= MNK_K)
+            return 1;
+    }
+    return 0;
+}
+
+/* Plays for the side to move; returns the winner, 'D' for a full board or ' ' */
+static inline char MNK_NAME(play)(MNK_NAME(Board)* board, int cell) {
+    char mover = board->toMove;
+    uint64_t* mask = (mover == 'X') ? board->x : board->o;
+    mask[cell >> 6] |= 1ull << (cell & 63);
+    board->moves++;
+    board->toMove = (mover == 'X') ? 'O' : 'X';
+    if (MNK_NAME(wins)(mask, cell))
+        return mover;
+    return board->moves == MNK_CELLS ? 'D' : ' ';
+}
+
+/* Index of the n-th (0-based) empty cell */
+static int MNK_NAME(nthEmpty)(const MNK_NAME(Board)* board, int n) {
+    for (int w = 0; w < MNK_WORDS; w++) {
+        uint64_t empty = ~(board->x[w] | board->o[w]);
+        if (w == MNK_WORDS - 1)
+            empty &= MNK_LAST_WORD;
+        int count = mnkCount(empty);
+        if (n < count) {
+            while (n-- > 0)
+                empty &= empty - 1;
+            return w * 64 + mnkFirst(empty);
+        }
+        n -= count;
+    }
+    return -1;
+}
+
+/* Lowest empty cell completing k in a row for player on a line through cell, or -1 */
+static int MNK_NAME(winNear)(const MNK_NAME(Board)* board, char player, int cell) {
+    const uint64_t* mask = MNK_NAME(stones)(board, player);
+    int row = cell / MNK_COLS, col = cell % MNK_COLS, best = -1;
+    for (int d = 0; d < 4; d++) {
+        int dr = mnkDirections[d][0], dc = mnkDirections[d][1];
+        for (int s = 1 - MNK_K; s < MNK_K; s++) {
+            int r = row + s * dr, c = col + s * dc, target = r * MNK_COLS + c;
+            if (s == 0 || r < 0 || r >= MNK_ROWS || c < 0 || c >= MNK_COLS)
+                continue;
+            if ((best < 0 || target < best) && MNK_NAME(isEmpty)(board, target) &&
+                MNK_NAME(run)(mask, target, dr, dc) >= MNK_K)
+                best = target;
+        }
+    }
+    return best;
+}
+
+/* Lowest empty cell completing k in a row for player anywhere, or -1 */
+static int MNK_NAME(winAnywhere)(const MNK_NAME(Board)* board, char player) {
+    const uint64_t* mask = MNK_NAME(stones)(board, player);
+    for (int cell = 0; cell < MNK_CELLS; cell++) {
+        if (MNK_NAME(isEmpty)(board, cell) && MNK_NAME(wins)(mask, cell))
+            return cell;
+    }
+    return -1;
+}
+
+/*
+ * Agent A's playout: win, else block, else the first empty cell in
+ * order. Since both sides always take a win, every threat left after the
+ * first two moves was made by one of the last two moves, so from then on
+ * only the lines through those need scanning; the cell found is the same
+ * as with a full scan.
+ */
+static char MNK_NAME(playoutA)(MNK_NAME(Board)* board, const short* order) {
+    int last = -1, previous = -1, next = 0;
+    char winner = ' ';
+    for (int step = 0; winner == ' '; step++) {
+        char mover = board->toMove;
+        char opponent = (mover == 'X') ? 'O' : 'X';
+        int cell;
+        if (step < 2) {
+            /* Threats from the tree can be anywhere */
+            cell = MNK_NAME(winAnywhere)(board, mover);
+            if (cell < 0)
+                cell = MNK_NAME(winAnywhere)(board, opponent);
+        } else {
+            cell = MNK_NAME(winNear)(board, mover, previous);
+            if (cell < 0)
+                cell = MNK_NAME(winNear)(board, opponent, last);
+        }
+        if (cell < 0) {
+            /* Cells only fill up, so the scan never goes back */
+            while (!MNK_NAME(isEmpty)(board, order[next]))
+                next++;
+            cell = order[next];
+        }
+        previous = last;
+        last = cell;
+        winner = MNK_NAME(play)(board, cell);
+    }
+    return winner;
+}
+
+/* Agent B's playout: uniformly random empty cells */
+static char MNK_NAME(playoutB)(MNK_NAME(Board)* board, Rng* rng) {
+    char winner = ' ';
+    while (winner == ' ') {
+        int cell = MNK_NAME(nthEmpty)(board, rngBelow(rng, MNK_CELLS - board->moves));
+        winner = MNK_NAME(play)(board, cell);
+    }
+    return winner;
+}
+
+/*
+ * Gives node one child per empty cell, each knowing whether its move ends
+ * the game. Returns 0, leaving node a leaf, when the arena is out of memory.
+ */
+static int MNK_NAME(expand)(MnkSearch* search, MnkNode* node, const MNK_NAME(Board)* board) {
+    int count = MNK_CELLS - board->moves;
+    const uint64_t* mask = MNK_NAME(stones)(board, board->toMove);
+    MnkNode* children = (MnkNode*)arenaAlloc(search->arena, count * sizeof(MnkNode));
+    if (children == NULL)
+        return 0;
+    int i = 0;
+    for (int w = 0; w < MNK_WORDS; w++) {
+        uint64_t empty = ~(board->x[w] | board->o[w]);
+        if (w == MNK_WORDS - 1)
+            empty &= MNK_LAST_WORD;
+        for (; empty; empty &= empty - 1) {
+            int cell = w * 64 + mnkFirst(empty);
+            char result = ' ';
+            if (MNK_NAME(wins)(mask, cell))
+                result = board->toMove;
+            else if (board->moves + 1 == MNK_CELLS)
+                result = 'D';
+            mnkInitNode(&children[i++], cell, result);
+        }
+    }
+    node->children = children;
+    node->childCount = count;
+    search->nodes += count;
+    return 1;
+}
+
+static int MNK_NAME(search)(Arena* arena, char agent, const MnkState* state,
+                            const SearchConfig* config, SearchResult* result) {
+    MNK_NAME(Board) position;
+    memset(&position, 0, sizeof(position));
+    for (int cell = 0; cell < MNK_CELLS; cell++) {
+        if (state->cells[cell] == 'X' || state->cells[cell] == 'O') {
+            uint64_t* mask = (state->cells[cell] == 'X') ? position.x : position.o;
+            mask[cell >> 6] |= 1ull << (cell & 63);
+            position.moves++;
+        }
+    }
+    position.toMove = state->toMove;
+
+    short order[MNK_CELLS];
+    mnkCentreOrder(order, MNK_ROWS, MNK_COLS);
+    MnkSearch search;
+    if (mnkBeginSearch(&search, arena, agent, state->toMove, config) != 0)
+        return -1;
+    MnkNode* root = search.root;
+
+    for (int iteration = 0; iteration < search.iterations; iteration++) {
+        if ((iteration & CLOCK_CHECK_MASK) == 0 && mnkShouldStop(&search, iteration))
+            break;
+
+        MNK_NAME(Board) board = position;
+        MnkNode* path[MNK_CELLS + 1];
+        int length = 0;
+        MnkNode* node = root;
+        path[length++] = node;
+
+        /* Selection, replaying the moves on the way down */
+        while (node->childCount > 0) {
+            node = mnkSelectChild(&search, node);
+            MNK_NAME(play)(&board, node->move);
+            path[length++] = node;
+        }
+
+        /* Expansion; agent A then steps into a random child, agent B plays out from the leaf */
+        if (node->result == ' ' && MNK_NAME(expand)(&search, node, &board)) {
+            if (agent == 'a') {
+                node = &node->children[rngBelow(&search.rng, node->childCount)];
+                MNK_NAME(play)(&board, node->move);
+                path[length++] = node;
+            }
+        }
+        if (length - 1 > search.maxDepth)
+            search.maxDepth = length - 1;
+
+        /* Simulation */
+        char winner = node->result;
+        if (winner == ' ') {
+            winner = (agent == 'a') ? MNK_NAME(playoutA)(&board, order) :
+                                      MNK_NAME(playoutB)(&board, &search.rng);
+        }
+
+        /* Backpropagation */
+        mnkBackpropagate(path, length, winner, search.player);
+    }
+
+    mnkEndSearch(&search, state, result);
+    return 0;
+}
+
+#undef MNK_LAST_WORD
+#undef MNK_WORDS
+#undef MNK_CELLS
+#undef MNK_NAME
+#undef MNK_K
+#undef MNK_COLS
+#undef MNK_ROWS
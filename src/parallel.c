@@ -0,0 +1,149 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <unistd.h>
+#endif
+#include "parallel.h"
+
+typedef struct {
+    WorkerFn fn;
+    void* arg;
+} WorkerStart;
+
+static void* workerMain(void* p) {
+    WorkerStart* start = (WorkerStart*)p;
+    start->fn(start->arg);
+    return NULL;
+}
+
+void parallelRun(WorkerFn fn, void* args, size_t argSize, int count) {
+    pthread_t threads[MAX_SEARCH_THREADS];
+    WorkerStart starts[MAX_SEARCH_THREADS];
+    int started[MAX_SEARCH_THREADS] = { 0 };
+
+    count = parallelThreads(count);
+    for (int i = 1; i < count; i++) {
+        starts[i].fn = fn;
+        starts[i].arg = (char*)args + i * argSize;
+        started[i] = pthread_create(&threads[i], NULL, workerMain, &starts[i]) == 0;
+        if (!started[i]) {
+            /* Could not get a thread; do the work on this one instead */
+            fn(starts[i].arg);
+        }
+    }
+    fn(args);
+    for (int i = 1; i < count; i++) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+    }
+}
+
+/* A share of parallelFor() tasks, [begin, end) packed as end << 32 | begin so one CAS moves both */
+typedef struct {
+    _Atomic uint64_t range;
+    char pad[64 - sizeof(uint64_t)]; /* One share per cache line */
+} TaskShare;
+
+typedef struct {
+    TaskFn fn;
+    void* context;
+    TaskShare* shares;
+    int threads;
+    int worker;
+} TaskWorker;
+
+static uint64_t packRange(uint32_t begin, uint32_t end) {
+    return (uint64_t)end << 32 | begin;
+}
+
+/* Takes the front task of the worker's own share; -1 when it is empty */
+static int takeTask(TaskShare* share) {
+    uint64_t range = atomic_load(&share->range);
+    for (;;) {
+        uint32_t begin = (uint32_t)range, end = (uint32_t)(range >> 32);
+        if (begin >= end)
+            return -1;
+        if (atomic_compare_exchange_weak(&share->range, &range, packRange(begin + 1, end)))
+            return (int)begin;
+    }
+}
+
+/* Moves the back half of the largest other share to the worker's own; 0 once all are empty */
+static int stealTasks(TaskWorker* worker) {
+    for (;;) {
+        int victim = -1;
+        uint32_t most = 0;
+        uint64_t range = 0;
+        for (int i = 0; i < worker->threads; i++) {
+            uint64_t r = atomic_load(&worker->shares[i].range);
+            uint32_t left = (uint32_t)(r >> 32) - (uint32_t)r;
+            if (i != worker->worker && (uint32_t)r < (uint32_t)(r >> 32) && left > most) {
+                victim = i;
+                most = left;
+                range = r;
+            }
+        }
+        if (victim < 0)
+            return 0;
+        uint32_t begin = (uint32_t)range, end = (uint32_t)(range >> 32);
+        uint32_t middle = begin + (end - begin) / 2;
+        /* A task is handed out once, so a range seen again is unchanged */
+        if (atomic_compare_exchange_strong(&worker->shares[victim].range, &range, packRange(begin, middle))) {
+            atomic_store(&worker->shares[worker->worker].range, packRange(middle, end));
+            return 1;
+        }
+    }
+}
+
+static void taskWorker(void* arg) {
+    TaskWorker* worker = (TaskWorker*)arg;
+    TaskShare* own = &worker->shares[worker->worker];
+    for (;;) {
+        int task = takeTask(own);
+        if (task < 0) {
+            if (!stealTasks(worker))
+                return;
+            continue;
+        }
+        worker->fn(worker->context, task, worker->worker);
+    }
+}
+
+void parallelFor(TaskFn fn, void* context, int count, int threads) {
+    TaskShare shares[MAX_SEARCH_THREADS];
+    TaskWorker workers[MAX_SEARCH_THREADS];
+    threads = parallelThreads(threads);
+    for (int i = 0; i < threads; i++) {
+        uint32_t begin = (uint32_t)((int64_t)count * i / threads);
+        uint32_t end = (uint32_t)((int64_t)count * (i + 1) / threads);
+        atomic_init(&shares[i].range, packRange(begin, end));
+        workers[i].fn = fn;
+        workers[i].context = context;
+        workers[i].shares = shares;
+        workers[i].threads = threads;
+        workers[i].worker = i;
+    }
+    parallelRun(taskWorker, workers, sizeof(TaskWorker), threads);
+}
+
+int parallelThreads(int requested) {
+    if (requested < 1)
+        return 1;
+    if (requested > MAX_SEARCH_THREADS)
+        return MAX_SEARCH_THREADS;
+    return requested;
+}
+
+int parallelCpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
@@ -0,0 +1,34 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+
+#define MAX_SEARCH_THREADS 64
+
+typedef void (*WorkerFn)(void* arg);
+
+/*
+ * Runs fn once per element of args (an array of count elements of
+ * argSize bytes), each on its own thread, and returns when all are done.
+ * Element 0 runs on the calling thread.
+ */
+void parallelRun(WorkerFn fn, void* args, size_t argSize, int count);
+
+typedef void (*TaskFn)(void* context, int task, int worker);
+
+/*
+ * Runs fn(context, task, worker) for every task in 0..count-1 on threads
+ * threads (worker 0 is the calling thread). Each thread starts on its own
+ * contiguous share of the tasks; once that runs out it steals the back
+ * half of the largest share left, so tasks of very different cost still
+ * keep every thread busy.
+ */
+void parallelFor(TaskFn fn, void* context, int count, int threads);
+
+/* Clamps a requested thread count to 1..MAX_SEARCH_THREADS */
+int parallelThreads(int requested);
+
+/* Number of online processors, at least 1 */
+int parallelCpuCount(void);
+
+#endif // PARALLEL_H
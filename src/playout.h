@@ -0,0 +1,78 @@
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+#include "bitboard.h"
+
+/*
+ * Incremental state for 3x3 playouts. Each side keeps the number of its
+ * marks in every line as 2-bit fields of one word (line i at bits 2i and
+ * 2i+1), so a move updates its lines with one addition, a win is a line
+ * at 3 and a win-in-one is a line at 2 the opponent has not touched.
+ */
+
+typedef struct {
+    BitBoard board;
+    unsigned lineCounts[2]; /* X, then O */
+    int emptyCount;
+} PlayoutState;
+
+/* Sum of 1 << 2i over the lines i through each cell */
+static const unsigned short playoutLineIncrement[BB_CELLS] = {
+    0x1041, 0x0101, 0x4401,
+    0x0044, 0x5104, 0x0404,
+    0x4050, 0x0110, 0x1410
+};
+
+#define PLAYOUT_LOW_BITS 0x5555u
+
+static inline int playoutSide(char player) {
+    return player == 'X' ? 0 : 1;
+}
+
+static inline unsigned playoutCountLines(unsigned mask) {
+    unsigned counts = 0;
+    for (; mask; mask &= mask - 1)
+        counts += playoutLineIncrement[bbFirst(mask)];
+    return counts;
+}
+
+/* For a position that is not over yet */
+static inline void playoutInit(PlayoutState* state, const BitBoard* board) {
+    state->board = *board;
+    state->lineCounts[0] = playoutCountLines(board->x);
+    state->lineCounts[1] = playoutCountLines(board->o);
+    state->emptyCount = bbCount(bbEmpty(board));
+}
+
+/* Plays for the side to move; returns the winner, 'D' for a full board or ' ' */
+static inline char playoutPlay(PlayoutState* state, int cell) {
+    char mover = state->board.toMove;
+    unsigned* counts = &state->lineCounts[playoutSide(mover)];
+    bbPlay(&state->board, cell);
+    *counts += playoutLineIncrement[cell];
+    state->emptyCount--;
+    /* A field of 3 has both bits set */
+    if (*counts & (*counts >> 1) & PLAYOUT_LOW_BITS)
+        return mover;
+    return state->emptyCount == 0 ? 'D' : ' ';
+}
+
+/*
+ * Finds the lowest empty cell that completes a line for player, the same
+ * cell a scan of every empty cell in order would find. Returns 0 if none.
+ */
+static inline int playoutWinningCell(const PlayoutState* state, char player, int* cell) {
+    unsigned own = state->lineCounts[playoutSide(player)];
+    unsigned other = state->lineCounts[playoutSide(bbOther(player))];
+    /* Lines where player has 2 (binary 10) and the opponent 0 */
+    unsigned open = (own >> 1) & ~own & ~(other | (other >> 1)) & PLAYOUT_LOW_BITS;
+    if (open == 0)
+        return 0;
+    unsigned cells = 0;
+    for (; open; open &= open - 1)
+        cells |= bbLines[bbFirst(open) / 2];
+    *cell = bbFirst(cells & bbEmpty(&state->board));
+    return 1;
+}
+
+#endif // PLAYOUT_H
@@ -0,0 +1,59 @@
+#include <pthread.h>
+#include "playout.h"
+#include "policy.h"
+
+static unsigned char moveTable[POLICY_ENTRIES];
+static pthread_once_t tableOnce = PTHREAD_ONCE_INIT;
+
+static int findWinningMove(const PlayoutState* state, char player, int *cell) {
+    // The lowest empty cell that completes one of player's lines
+    return playoutWinningCell(state, player, cell);
+}
+
+static int findBlockingMove(const PlayoutState* state, char player, int *cell) {
+    return findWinningMove(state, bbOther(player), cell);
+}
+
+static int selectRandomMove(const BitBoard* state) {
+    // Prioritize center, then corners, then edges
+    static const int preferredMoves[BB_CELLS] = {
+        4,          // Center
+        0, 2, 6, 8, // Corners
+        1, 3, 5, 7  // Edges
+    };
+    unsigned empty = bbEmpty(state);
+    for (int i = 0; i < BB_CELLS; i++) {
+        if (empty & BB_BIT(preferredMoves[i]))
+            return preferredMoves[i];
+    }
+    return bbFirst(empty);
+}
+
+int policyHeuristicMove(const BitBoard* board) {
+    PlayoutState state;
+    playoutInit(&state, board);
+    int cell;
+    char mover = board->toMove;
+    if (!findWinningMove(&state, mover, &cell) && !findBlockingMove(&state, mover, &cell))
+        cell = selectRandomMove(board);
+    return cell;
+}
+
+static void buildTable(void) {
+    for (unsigned x = 0; x < 512; x++) {
+        for (unsigned o = 0; o < 512; o++) {
+            /* Overlapping masks and full boards are never looked up */
+            if ((x & o) != 0 || (x | o) == BB_FULL)
+                continue;
+            BitBoard xToMove = { (unsigned short)x, (unsigned short)o, 'X' };
+            BitBoard oToMove = { (unsigned short)x, (unsigned short)o, 'O' };
+            moveTable[x << 9 | o] = (unsigned char)(policyHeuristicMove(&xToMove) |
+                                                    policyHeuristicMove(&oToMove) << 4);
+        }
+    }
+}
+
+const unsigned char* policyTable(void) {
+    pthread_once(&tableOnce, buildTable);
+    return moveTable;
+}
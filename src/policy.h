@@ -0,0 +1,28 @@
+#ifndef POLICY_H
+#define POLICY_H
+
+#include "bitboard.h"
+
+/*
+ * Agent A's playout policy: win if possible, else block the opponent's
+ * win, else take the center, then a corner, then an edge; both scans take
+ * the lowest cell. policyTable() holds its answer for every pair of X and
+ * O masks, low nibble for X to move and high nibble for O, so a playout
+ * step is one load. policyHeuristicMove() is the scan the table is built
+ * from; the bench cross-checks them.
+ */
+
+#define POLICY_ENTRIES (512 * 512)
+
+/* Built on first use */
+const unsigned char* policyTable(void);
+
+/* For a position with an empty cell */
+int policyHeuristicMove(const BitBoard* board);
+
+static inline int policyMove(const unsigned char* table, const BitBoard* board) {
+    unsigned entry = table[(unsigned)board->x << 9 | board->o];
+    return board->toMove == 'X' ? entry & 0xF : entry >> 4;
+}
+
+#endif // POLICY_H
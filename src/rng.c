@@ -0,0 +1,30 @@
+#include "common.h"
+#include "rng.h"
+
+/* Per thread, so each tournament game can seed its own streams */
+static THREAD_LOCAL uint64_t baseSeed = 0x2545F4914F6CDD1DULL;
+static THREAD_LOCAL uint64_t streamCounter;
+
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rngSetSeed(uint64_t seed) {
+    baseSeed = seed;
+    streamCounter = 0;
+}
+
+uint64_t rngStreamSeed(void) {
+    uint64_t state = baseSeed + streamCounter++ * 0xD1B54A32D192ED03ULL;
+    return splitmix64(&state);
+}
+
+void rngInit(Rng* rng, uint64_t seed) {
+    do {
+        for (int i = 0; i < 4; i++)
+            rng->s[i] = (uint32_t)(splitmix64(&seed) >> 32);
+    } while ((rng->s[0] | rng->s[1] | rng->s[2] | rng->s[3]) == 0);
+}
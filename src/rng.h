@@ -0,0 +1,53 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/*
+ * xoshiro128** generator. Each search (and each search thread) owns one,
+ * so random decisions never contend on shared state the way rand() does.
+ */
+typedef struct {
+    uint32_t s[4];
+} Rng;
+
+/* Sets the seed the calling thread derives all its streams from */
+void rngSetSeed(uint64_t seed);
+
+/* Returns a fresh seed for a new stream; deterministic for a given rngSetSeed() */
+uint64_t rngStreamSeed(void);
+
+void rngInit(Rng* rng, uint64_t seed);
+
+static inline uint32_t rngRotl(uint32_t x, int k) {
+    return (x << k) | (x >> (32 - k));
+}
+
+static inline uint32_t rngNext(Rng* rng) {
+    uint32_t* s = rng->s;
+    uint32_t result = rngRotl(s[1] * 5, 7) * 9;
+    uint32_t t = s[1] << 9;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rngRotl(s[3], 11);
+    return result;
+}
+
+/* Uniform integer in [0, n) without modulo bias (Lemire's method); n > 0 */
+static inline uint32_t rngBelow(Rng* rng, uint32_t n) {
+    uint64_t m = (uint64_t)rngNext(rng) * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t threshold = (0u - n) % n;
+        while (low < threshold) {
+            m = (uint64_t)rngNext(rng) * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+#endif // RNG_H
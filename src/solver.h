@@ -0,0 +1,52 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "bitboard.h"
+#include "table.h"
+
+/*
+ * Proven values for MCTS-Solver. A node's value is the winner of its
+ * position under perfect play ('X', 'O' or 'D' for a draw), or ' ' while
+ * unknown. Values do not depend on whose statistics the tree holds, so
+ * they survive tree reuse and shared (transposed) nodes.
+ */
+
+/*
+ * Value of a position with mover to play, from its children's values:
+ * a win if any child wins for mover; otherwise known only once every
+ * child is, a draw if one of them draws and a loss if none does.
+ */
+static inline char solverValue(char mover, const char* childValues, int count) {
+    int unknown = 0, draw = 0;
+    for (int i = 0; i < count; i++) {
+        if (childValues[i] == mover)
+            return mover;
+        if (childValues[i] == ' ')
+            unknown = 1;
+        else if (childValues[i] == 'D')
+            draw = 1;
+    }
+    if (unknown)
+        return ' ';
+    return draw ? 'D' : bbOther(mover);
+}
+
+/* Value of a new node: its winner if the game is over, else what the table knows, if any */
+static inline char solverInitialValue(const Table* table, const BitBoard* bb) {
+    char winner = bbWinner(bb);
+    if (winner != ' ' || table == NULL)
+        return winner;
+    return tableLookup(table, bb, NULL);
+}
+
+/* Exact win rate of a proven value for player */
+static inline double solverWinRate(char value, char player) {
+    return (value == player) ? 1.0 : (value == 'D') ? 0.5 : 0.0;
+}
+
+/* Half-wins of one playout ending in result, for player */
+static inline int solverHalfWins(char result, char player) {
+    return (result == player) ? 2 : (result == 'D') ? 1 : 0;
+}
+
+#endif // SOLVER_H
@@ -0,0 +1,101 @@
+#include <math.h>
+#include "sprt.h"
+
+#define SPRT_Z95 1.959964 /* Two-sided 95% normal quantile */
+
+/* Expected score at an Elo difference */
+static double eloScore(double elo) {
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+/* Elo difference at an expected score, kept off the infinite ends */
+static double scoreElo(double score) {
+    if (score < 1e-6)
+        score = 1e-6;
+    if (score > 1.0 - 1e-6)
+        score = 1.0 - 1e-6;
+    return -400.0 * log10(1.0 / score - 1.0) + 0.0; /* Not -0 at even scores */
+}
+
+/* Mean and variance of one game's score, with half a game of each result as a prior */
+static void scoreMoments(const Sprt* sprt, double* mean, double* variance) {
+    double wins = sprt->wins + 0.5, draws = sprt->draws + 0.5, losses = sprt->losses + 0.5;
+    double n = wins + draws + losses;
+    *mean = (wins + 0.5 * draws) / n;
+    *variance = (wins * (1.0 - *mean) * (1.0 - *mean) + draws * (0.5 - *mean) * (0.5 - *mean) +
+                 losses * *mean * *mean) / n;
+}
+
+static double logLikelihoodRatio(int games, double mean, double variance, double elo0, double elo1) {
+    double s0 = eloScore(elo0), s1 = eloScore(elo1);
+    return games * (s1 - s0) * (2.0 * mean - s0 - s1) / (2.0 * variance);
+}
+
+/* Moves a test that is still running to 1 (alternative) or -1 (null) once llr crosses a bound */
+static void settle(const Sprt* sprt, int* settled, double llr) {
+    if (*settled != 0)
+        return;
+    if (llr >= sprt->upper)
+        *settled = 1;
+    else if (llr <= sprt->lower)
+        *settled = -1;
+}
+
+void sprtInit(Sprt* sprt, const SprtConfig* config) {
+    sprt->config = *config;
+    if (sprt->config.elo1 <= sprt->config.elo0)
+        sprt->config.elo1 = sprt->config.elo0 + SPRT_ELO1;
+    if (sprt->config.alpha <= 0)
+        sprt->config.alpha = SPRT_ALPHA;
+    if (sprt->config.beta <= 0)
+        sprt->config.beta = SPRT_BETA;
+    sprt->wins = sprt->draws = sprt->losses = 0;
+    sprt->llrFirst = sprt->llrSecond = 0;
+    sprt->lower = log(sprt->config.beta / (1.0 - sprt->config.alpha));
+    sprt->upper = log((1.0 - sprt->config.beta) / sprt->config.alpha);
+    sprt->settledFirst = sprt->settledSecond = 0;
+    sprt->result = SPRT_CONTINUE;
+}
+
+SprtResult sprtAdd(Sprt* sprt, char winner) {
+    if (sprt->result != SPRT_CONTINUE)
+        return sprt->result;
+    if (winner == 'X')
+        sprt->wins++;
+    else if (winner == 'O')
+        sprt->losses++;
+    else
+        sprt->draws++;
+
+    int games = sprt->wins + sprt->draws + sprt->losses;
+    double mean, variance;
+    scoreMoments(sprt, &mean, &variance);
+    const SprtConfig* config = &sprt->config;
+    sprt->llrFirst = logLikelihoodRatio(games, mean, variance, config->elo0, config->elo1);
+    sprt->llrSecond = logLikelihoodRatio(games, mean, variance, -config->elo0, -config->elo1);
+    settle(sprt, &sprt->settledFirst, sprt->llrFirst);
+    settle(sprt, &sprt->settledSecond, sprt->llrSecond);
+
+    if (sprt->settledFirst > 0)
+        sprt->result = SPRT_FIRST;
+    else if (sprt->settledSecond > 0)
+        sprt->result = SPRT_SECOND;
+    else if (sprt->settledFirst < 0 && sprt->settledSecond < 0)
+        sprt->result = SPRT_EQUAL;
+    return sprt->result;
+}
+
+void sprtElo(const Sprt* sprt, double* elo, double* low, double* high) {
+    int games = sprt->wins + sprt->draws + sprt->losses;
+    double mean, variance;
+    scoreMoments(sprt, &mean, &variance);
+    double margin = games > 0 ? SPRT_Z95 * sqrt(variance / games) : 0.5;
+    *elo = scoreElo(mean);
+    *low = scoreElo(mean - margin);
+    *high = scoreElo(mean + margin);
+}
+
+const char* sprtResultName(SprtResult result) {
+    static const char* names[] = { "inconclusive", "first", "second", "equal" };
+    return names[result];
+}
@@ -0,0 +1,51 @@
+#ifndef SPRT_H
+#define SPRT_H
+
+/*
+ * Sequential probability ratio test on a series of games, from the first
+ * agent's side. Two tests run side by side: elo0 against elo1 ("first is
+ * stronger") and -elo0 against -elo1 ("second is stronger"). The run is
+ * settled once either accepts its stronger hypothesis, or both accept
+ * theirs of no difference, which proves the agents equal to within elo1.
+ * The log-likelihood ratio uses the normal approximation of the score
+ * over wins, draws and losses, with half a game of each as a prior so
+ * that one-sided and all-draw runs keep a finite variance.
+ */
+
+typedef enum {
+    SPRT_CONTINUE,
+    SPRT_FIRST,  /* First agent stronger */
+    SPRT_SECOND, /* Second agent stronger */
+    SPRT_EQUAL   /* Neither stronger by elo1 */
+} SprtResult;
+
+typedef struct {
+    double elo0, elo1;  /* Elo difference of no and of a real improvement, elo0 < elo1 */
+    double alpha, beta; /* False positive and false negative rates */
+} SprtConfig;
+
+typedef struct {
+    SprtConfig config;
+    int wins, draws, losses;
+    double llrFirst, llrSecond; /* Log-likelihood ratios of the two tests */
+    double lower, upper;        /* Bounds accepting the null and the alternative */
+    int settledFirst, settledSecond; /* 1 once a test accepts its alternative, -1 its null */
+    SprtResult result;
+} Sprt;
+
+/* Defaults for the fields of config left at 0 */
+#define SPRT_ELO1 20.0
+#define SPRT_ALPHA 0.05
+#define SPRT_BETA 0.05
+
+void sprtInit(Sprt* sprt, const SprtConfig* config);
+
+/* Adds a game won by 'X' (the first agent), 'O' or drawn ('D'); returns the result so far */
+SprtResult sprtAdd(Sprt* sprt, char winner);
+
+/* Elo difference of the first agent over the second with its 95% confidence interval */
+void sprtElo(const Sprt* sprt, double* elo, double* low, double* high);
+
+const char* sprtResultName(SprtResult result);
+
+#endif // SPRT_H
@@ -0,0 +1,61 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include "bitboard.h"
+
+/*
+ * The eight rotations and reflections of the 3x3 board (the dihedral
+ * group D4). Moves that one of the position's own symmetries maps onto
+ * each other lead to equivalent games, so the agents expand only one of
+ * them and its statistics stand for the whole set.
+ */
+
+#define SYM_COUNT 8
+
+/* Image of each cell: identity, three rotations, then four reflections */
+static const unsigned char symCells[SYM_COUNT][BB_CELLS] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8 },
+    { 2, 5, 8, 1, 4, 7, 0, 3, 6 },
+    { 8, 7, 6, 5, 4, 3, 2, 1, 0 },
+    { 6, 3, 0, 7, 4, 1, 8, 5, 2 },
+    { 2, 1, 0, 5, 4, 3, 8, 7, 6 },
+    { 6, 7, 8, 3, 4, 5, 0, 1, 2 },
+    { 0, 3, 6, 1, 4, 7, 2, 5, 8 },
+    { 8, 5, 2, 7, 4, 1, 6, 3, 0 }
+};
+
+static inline unsigned symMap(unsigned mask, int symmetry) {
+    unsigned image = 0;
+    for (; mask; mask &= mask - 1)
+        image |= BB_BIT(symCells[symmetry][bbFirst(mask)]);
+    return image;
+}
+
+/* The cell that symmetry maps onto cell */
+static inline int symInverseCell(int cell, int symmetry) {
+    int source = 0;
+    while (symCells[symmetry][source] != cell)
+        source++;
+    return source;
+}
+
+/*
+ * Empty cells of bb, keeping the lowest cell of each set of moves the
+ * symmetries fixing bb map onto each other: 3 moves on the empty board
+ * instead of 9, and all of them once the position has no symmetry.
+ */
+static inline unsigned symDistinctMoves(const BitBoard* bb) {
+    unsigned empty = bbEmpty(bb), moves = empty;
+    for (int symmetry = 1; symmetry < SYM_COUNT; symmetry++) {
+        if (symMap(bb->x, symmetry) != bb->x || symMap(bb->o, symmetry) != bb->o)
+            continue;
+        for (unsigned rest = empty; rest; rest &= rest - 1) {
+            int cell = bbFirst(rest);
+            if (symCells[symmetry][cell] < cell)
+                moves &= ~BB_BIT(cell);
+        }
+    }
+    return moves;
+}
+
+#endif // SYMMETRY_H
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mapfile.h"
+#include "table.h"
+
+#define TABLE_MAX_KEY 64
+
+int tableOpen(Table* table, const char* path) {
+    memset(table, 0, sizeof(*table));
+    size_t size = 0;
+    void* data = mapFile(path, &size);
+    if (data == NULL)
+        return -1;
+
+    TableHeader header;
+    if (size >= sizeof(header))
+        memcpy(&header, data, sizeof(header));
+    if (size < sizeof(header) || memcmp(header.magic, TABLE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.keyBytes > TABLE_MAX_KEY || header.moveBytes * 8 < header.rows * header.cols) {
+        unmapFile(data, size);
+        return -1;
+    }
+    table->rows = header.rows;
+    table->cols = header.cols;
+    table->k = header.k;
+    table->keyBytes = header.keyBytes;
+    table->moveBytes = header.moveBytes;
+    table->recordSize = (size_t)header.keyBytes + 1 + header.moveBytes;
+    table->count = header.count;
+    if (size < sizeof(header) + table->count * table->recordSize) {
+        unmapFile(data, size);
+        return -1;
+    }
+    table->records = (const unsigned char*)data + sizeof(header);
+    table->data = data;
+    table->size = size;
+    return 0;
+}
+
+void tableClose(Table* table) {
+    if (table->data != NULL)
+        unmapFile(table->data, table->size);
+    memset(table, 0, sizeof(*table));
+}
+
+void tableKey(const unsigned char* digits, int cells, char toMove, unsigned char* key, int keyBytes) {
+    memset(key, 0, (size_t)keyBytes);
+    key[keyBytes - 1] = toMove == 'O';
+    /* key = key * 3 + digit, from the highest cell down */
+    for (int cell = cells - 1; cell >= 0; cell--) {
+        unsigned carry = digits[cell];
+        for (int i = keyBytes - 1; i >= 0; i--) {
+            unsigned value = key[i] * 3u + carry;
+            key[i] = (unsigned char)value;
+            carry = value >> 8;
+        }
+    }
+}
+
+const unsigned char* tableFind(const Table* table, const unsigned char* digits, char toMove) {
+    int cells = table->rows * table->cols;
+    if (table->keyBytes == 0) {
+        uint64_t index = toMove == 'O';
+        for (int cell = cells - 1; cell >= 0; cell--)
+            index = index * 3 + digits[cell];
+        return index < table->count ? table->records + index * table->recordSize : NULL;
+    }
+
+    unsigned char key[TABLE_MAX_KEY];
+    tableKey(digits, cells, toMove, key, table->keyBytes);
+    size_t low = 0, high = table->count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        const unsigned char* record = table->records + middle * table->recordSize;
+        int order = memcmp(record, key, (size_t)table->keyBytes);
+        if (order == 0)
+            return record + table->keyBytes;
+        if (order < 0)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return NULL;
+}
+
+char tableLookup(const Table* table, const BitBoard* bb, unsigned* moves) {
+    if (table == NULL || table->rows != 3 || table->cols != 3 || table->k != 3)
+        return ' ';
+    const unsigned char* record;
+    if (table->keyBytes == 0) {
+        unsigned index = bbIndex(bb);
+        record = index < table->count ? table->records + index * table->recordSize : NULL;
+    } else {
+        unsigned char digits[BB_CELLS];
+        for (int cell = 0; cell < BB_CELLS; cell++)
+            digits[cell] = (bb->x & BB_BIT(cell)) ? 1 : (bb->o & BB_BIT(cell)) ? 2 : 0;
+        record = tableFind(table, digits, bb->toMove);
+    }
+    if (record == NULL || record[0] == 0)
+        return ' ';
+    if (moves != NULL)
+        *moves = record[1] | (unsigned)record[2] << 8;
+    return (char)record[0];
+}
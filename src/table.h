@@ -0,0 +1,65 @@
+#ifndef TABLE_H
+#define TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bitboard.h"
+
+/*
+ * Solved-position tables, written offline by mcts_tablegen and mapped
+ * read-only at startup. A position's key is its base-3 index: cell i
+ * (row by row) contributes 3^i times 0 (empty), 1 (X) or 2 (O), plus
+ * 3^cells when O is to move, which for 3x3 is bbIndex().
+ *
+ * File layout: a TableHeader, then count records of
+ *   key        keyBytes bytes, big-endian (absent in a dense table)
+ *   value      1 byte: the winner under perfect play, 'X', 'O' or 'D',
+ *              or 0 if the position was not solved
+ *   best moves moveBytes bytes, bit i of byte i / 8 set for cell i
+ * A dense table (keyBytes 0) holds every index in order and answers with
+ * one read; a keyed table holds any subset of positions, such as an
+ * opening book or the endgames of a larger board, sorted by key.
+ */
+
+#define TABLE_MAGIC "MCTSTAB1"
+
+typedef struct {
+    char magic[8];
+    uint8_t rows, cols, k;
+    uint8_t keyBytes;  /* 0 for a dense table */
+    uint8_t moveBytes;
+    uint8_t reserved[3];
+    uint32_t count;    /* Records */
+} TableHeader;
+
+typedef struct Table {
+    int rows, cols, k;
+    int keyBytes, moveBytes;
+    size_t recordSize;
+    size_t count;
+    const unsigned char* records;
+    void* data; /* The whole file, mapped */
+    size_t size;
+} Table;
+
+/* Maps the file at path; returns 0, or -1 if it is missing or not a table */
+int tableOpen(Table* table, const char* path);
+void tableClose(Table* table);
+
+/*
+ * Record of a position given as rows * cols digits (0 empty, 1 X, 2 O),
+ * pointing at its value byte with the best moves after it; NULL when the
+ * table does not hold it.
+ */
+const unsigned char* tableFind(const Table* table, const unsigned char* digits, char toMove);
+
+/*
+ * Value of a 3x3 position in a 3x3 table, ' ' if unknown. When moves is
+ * not NULL it receives the best moves as a cell mask.
+ */
+char tableLookup(const Table* table, const BitBoard* bb, unsigned* moves);
+
+/* Writes the key of a position in keyBytes bytes, big-endian */
+void tableKey(const unsigned char* digits, int cells, char toMove, unsigned char* key, int keyBytes);
+
+#endif // TABLE_H
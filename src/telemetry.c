@@ -0,0 +1,64 @@
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include "common.h"
+#include "telemetry.h"
+
+#define TELEMETRY_BUFFER (1 << 16) /* Bytes of records gathered before a write */
+
+static FILE* stream;
+static pthread_mutex_t streamLock = PTHREAD_MUTEX_INITIALIZER;
+static THREAD_LOCAL int currentGame;
+static THREAD_LOCAL int currentPly;
+
+int telemetryOpen(const char* path) {
+    FILE* file = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (file == NULL)
+        return -1;
+    setvbuf(file, NULL, _IOFBF, TELEMETRY_BUFFER);
+    stream = file;
+    return 0;
+}
+
+void telemetryClose(void) {
+    if (stream == NULL)
+        return;
+    if (stream != stdout)
+        fclose(stream);
+    else
+        fflush(stream);
+    stream = NULL;
+}
+
+void telemetryBeginGame(int game) {
+    currentGame = game;
+    currentPly = 0;
+}
+
+void telemetryRecord(char agent, char player, const SearchResult* result) {
+    if (stream == NULL)
+        return;
+    int ply = ++currentPly;
+
+    /* Formatted outside the lock so that only the write is serialised */
+    char line[1024];
+    double playoutsPerSec = result->elapsedMs > 0 ? result->iterations * 1000.0 / result->elapsedMs : 0;
+    int length = snprintf(line, sizeof(line),
+        "{\"game\":%d,\"ply\":%d,\"agent\":\"%c\",\"player\":\"%c\",\"row\":%d,\"col\":%d,"
+        "\"win_rate\":%.4f,\"iterations\":%d,\"nodes\":%d,\"bytes\":%zu,\"max_depth\":%d,"
+        "\"reused_visits\":%d,\"stopped_early\":%d,\"elapsed_ms\":%.3f,\"playouts_per_sec\":%.0f,"
+        "\"select_ms\":%.3f,\"expand_ms\":%.3f,\"simulate_ms\":%.3f,\"backup_ms\":%.3f,"
+        "\"root_visits\":[%d,%d,%d,%d,%d,%d,%d,%d,%d]}\n",
+        currentGame, ply, agent, player, result->row, result->col, result->winRate,
+        result->iterations, result->nodes, result->nodeBytes, result->maxDepth,
+        result->reusedVisits, result->stoppedEarly, result->elapsedMs, playoutsPerSec,
+        result->phaseMs[PHASE_SELECT], result->phaseMs[PHASE_EXPAND],
+        result->phaseMs[PHASE_SIMULATE], result->phaseMs[PHASE_BACKUP],
+        result->rootVisits[0], result->rootVisits[1], result->rootVisits[2],
+        result->rootVisits[3], result->rootVisits[4], result->rootVisits[5],
+        result->rootVisits[6], result->rootVisits[7], result->rootVisits[8]);
+
+    pthread_mutex_lock(&streamLock);
+    fwrite(line, 1, (size_t)length, stream);
+    pthread_mutex_unlock(&streamLock);
+}
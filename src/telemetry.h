@@ -0,0 +1,27 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "engine.h"
+
+/*
+ * Per-move search telemetry as JSON lines: one record per move searched
+ * with the SearchResult statistics (iterations, nodes and memory, depth,
+ * phase times, root visits and playouts per second). Records from games
+ * on several threads are written whole, tagged with the game and ply.
+ * Nothing is written, and nothing costs more than a test, until
+ * telemetryOpen() succeeds.
+ */
+
+/* Starts streaming to path, "-" for stdout; returns 0 on success */
+int telemetryOpen(const char* path);
+
+/* Flushes and closes the stream */
+void telemetryClose(void);
+
+/* Tags the calling thread's following records with game, 1-based, and restarts the ply count */
+void telemetryBeginGame(int game);
+
+/* Writes the record of a move agent chose for player, if a stream is open */
+void telemetryRecord(char agent, char player, const SearchResult* result);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,45 @@
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+#include <pthread.h>
+#include "timing.h"
+
+#define CALIBRATION_CALLS 1000
+#define CALIBRATION_ROUNDS 5
+
+static pthread_once_t calibrated = PTHREAD_ONCE_INIT;
+static double callCostMs;
+
+double timeNowMs(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1e6;
+#endif
+}
+
+/* The cheapest of a few rounds, so a preempted round does not count */
+static void calibrate(void) {
+    double best = -1;
+    for (int round = 0; round < CALIBRATION_ROUNDS; round++) {
+        double start = timeNowMs(), now = start;
+        for (int i = 0; i < CALIBRATION_CALLS; i++)
+            now = timeNowMs();
+        double cost = (now - start) / CALIBRATION_CALLS;
+        if (best < 0 || cost < best)
+            best = cost;
+    }
+    callCostMs = best;
+}
+
+double timeNowCostMs(void) {
+    pthread_once(&calibrated, calibrate);
+    return callCostMs;
+}
@@ -0,0 +1,10 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+/* Monotonic wall-clock time in milliseconds */
+double timeNowMs(void);
+
+/* Cost of one timeNowMs() call, measured once on first use */
+double timeNowCostMs(void);
+
+#endif // TIMING_H
@@ -0,0 +1,124 @@
+#include <stdatomic.h>
+#include <string.h>
+#include <pthread.h>
+#include "common.h"
+#include "rng.h"
+#include "parallel.h"
+#include "tournament.h"
+#include "mnk.h"
+#include "telemetry.h"
+#include "gamelog.h"
+
+/* Games finished so far, fed to the sequential test in order */
+typedef struct {
+    pthread_mutex_t lock;
+    int counted;      /* Games before the first one still being played */
+    atomic_int stop;  /* Set once the test settles */
+} Progress;
+
+typedef struct {
+    const Tournament* tournament;
+    char* winners;
+    atomic_int* nextGame;
+    Progress* progress;
+    int worker;
+} GameWorker;
+
+/* Same as the 3x3 loop below, on a private m,n,k board */
+static char playMnkGame(const Tournament* tournament, int turn) {
+    MnkState state;
+    mnkInit(&state, tournament->rows, tournament->cols, tournament->k);
+    state.toMove = (turn == 0) ? 'X' : 'O';
+    SearchConfig config;
+    globalSearchConfig(&config);
+
+    char winner = ' ';
+    while (winner == ' ') {
+        char agent = (state.toMove == 'X') ? tournament->firstAgent : tournament->secondAgent;
+        SearchResult result;
+        config.exploration = agentExploration(agent);
+        if (engineSearchMnk(threadEngine(), agent, &state, &config, &result) != 0)
+            return 'D';
+        telemetryRecord(agent, state.toMove, &result);
+        gamelogMove(state.toMove, result.row * state.cols + result.col, &result);
+        winner = mnkPlay(&state, result.row, result.col);
+    }
+    return winner;
+}
+
+static char playGame(const Tournament* tournament, int game) {
+    rngSetSeed(tournament->seed + (uint64_t)game * 0x9E3779B97F4A7C15ULL);
+    Rng rng;
+    rngInit(&rng, rngStreamSeed());
+    telemetryBeginGame(game + 1);
+    if (tournament->k > 0)
+        return playMnkGame(tournament, rngBelow(&rng, 2));
+
+    initBoard();
+    char winner = ' ';
+    int turn = rngBelow(&rng, 2); /* Randomly select starting player (0 or 1) */
+    while (winner == ' ') {
+        if (turn == 0) {
+            move(tournament->firstAgent, 'X');
+            turn = 1;
+        } else {
+            move(tournament->secondAgent, 'O');
+            turn = 0;
+        }
+        winner = checkWinner();
+    }
+    return winner;
+}
+
+static void gameWorker(void* arg) {
+    GameWorker* worker = (GameWorker*)arg;
+    const Tournament* tournament = worker->tournament;
+    Progress* progress = worker->progress;
+    int game;
+    while (!atomic_load(&progress->stop) &&
+           (game = atomic_fetch_add(worker->nextGame, 1)) < tournament->numGames) {
+        gamelogBeginGame(game + 1);
+        char winner = playGame(tournament, game);
+        gamelogEndGame(winner);
+        if (tournament->sprt == NULL) {
+            worker->winners[game] = winner;
+            continue;
+        }
+        /* Count the finished prefix; games after the one that settles the test are dropped */
+        pthread_mutex_lock(&progress->lock);
+        worker->winners[game] = winner;
+        while (!atomic_load(&progress->stop) && progress->counted < tournament->numGames &&
+               worker->winners[progress->counted] != 0) {
+            if (sprtAdd(tournament->sprt, worker->winners[progress->counted++]) != SPRT_CONTINUE)
+                atomic_store(&progress->stop, 1);
+        }
+        pthread_mutex_unlock(&progress->lock);
+    }
+    /* Worker 0 is the calling thread, which keeps its agents' memory */
+    if (worker->worker > 0) {
+        releaseAgents();
+    }
+}
+
+int runTournament(const Tournament* tournament, char* winners) {
+    GameWorker workers[MAX_SEARCH_THREADS];
+    atomic_int nextGame;
+    Progress progress;
+    int jobs = parallelThreads(tournament->jobs);
+
+    atomic_init(&nextGame, 0);
+    pthread_mutex_init(&progress.lock, NULL);
+    progress.counted = 0;
+    atomic_init(&progress.stop, 0);
+    memset(winners, 0, tournament->numGames > 0 ? tournament->numGames : 0);
+    for (int w = 0; w < jobs; w++) {
+        workers[w].tournament = tournament;
+        workers[w].winners = winners;
+        workers[w].nextGame = &nextGame;
+        workers[w].progress = &progress;
+        workers[w].worker = w;
+    }
+    parallelRun(gameWorker, workers, sizeof(GameWorker), jobs);
+    pthread_mutex_destroy(&progress.lock);
+    return tournament->sprt ? progress.counted : tournament->numGames;
+}
@@ -0,0 +1,28 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <stdint.h>
+#include "sprt.h"
+
+/* A series of games between two agents ('a', 'b' or 'c') */
+typedef struct {
+    char firstAgent;  /* Plays X */
+    char secondAgent; /* Plays O */
+    int numGames;
+    int jobs;         /* Threads playing games; 1 plays them on the calling thread */
+    uint64_t seed;
+    int rows, cols, k; /* An m,n,k board (see mnk.h); k = 0 plays on the global 3x3 board */
+    Sprt* sprt;        /* Stops the run once the test settles; NULL plays every game */
+} Tournament;
+
+/*
+ * Plays the games and stores the winner of game i + 1 ('X', 'O' or 'D')
+ * in winners[i]. Each game seeds its random streams from the tournament
+ * seed and its own number and starts from fresh agent state, so the
+ * results do not depend on how games are spread over threads. With a
+ * sequential test, games are fed to it in order and the run ends at the
+ * game that settles it; returns the number of games counted.
+ */
+int runTournament(const Tournament* tournament, char* winners);
+
+#endif // TOURNAMENT_H
@@ -0,0 +1,66 @@
+#include <string.h>
+#include "solver.h"
+#include "tree.h"
+
+/* Bytes of a block of count children */
+#define BLOCK_BYTES(count) ((size_t)(count) * (4 * sizeof(int) + 2))
+
+void treeInit(Tree* tree, Arena* arena, TransTable* table, const Table* solved) {
+    tree->arena = arena;
+    tree->table = table;
+    tree->solved = solved;
+    tree->count = 0;
+}
+
+NodeId treeAdd(Tree* tree, const BitBoard* state) {
+    NodeId id = tree->count;
+    if ((id & (TREE_CHUNK - 1)) == 0) {
+        TreeNode* chunk = (TreeNode*)arenaAlloc(tree->arena, TREE_CHUNK * sizeof(TreeNode));
+        if (chunk == NULL)
+            return TT_NONE;
+        tree->chunks[id >> TREE_CHUNK_BITS] = chunk;
+    }
+    tree->count++;
+    TreeNode* node = treeNode(tree, id);
+    atomic_init(&node->visits, 0);
+    atomic_init(&node->childCount, 0);
+    atomic_init(&node->expanded, 0);
+    atomic_init(&node->proven, solverInitialValue(tree->solved, state));
+    node->block = NULL;
+    ttStore(tree->table, bbIndex(state), id);
+    return id;
+}
+
+NodeId treeFindOrAdd(Tree* tree, const BitBoard* state) {
+    NodeId id = ttLookup(tree->table, bbIndex(state));
+    return id != TT_NONE ? id : treeAdd(tree, state);
+}
+
+Children treeAllocChildren(Tree* tree, TreeNode* node, int count) {
+    node->block = arenaAlloc(tree->arena, BLOCK_BYTES(count));
+    if (node->block == NULL) {
+        Children none = { 0 };
+        return none;
+    }
+    memset(node->block, 0, BLOCK_BYTES(count));
+    return treeChildren(node, count);
+}
+
+int treeExpand(Tree* tree, TreeNode* node, const BitBoard* state, unsigned moves) {
+    int count = bbCount(moves);
+    Children children = treeAllocChildren(tree, node, count);
+    if (node->block == NULL)
+        return 0;
+    for (int i = 0; moves; i++, moves &= moves - 1) {
+        BitBoard next = *state;
+        bbPlay(&next, bbFirst(moves));
+        children.nodes[i] = treeFindOrAdd(tree, &next);
+        if (children.nodes[i] == TT_NONE)
+            return 0; /* The block stays unpublished */
+        children.moves[i] = (unsigned char)bbFirst(moves);
+        atomic_init(&children.proven[i], atomic_load_explicit(&treeNode(tree, children.nodes[i])->proven,
+                                                              memory_order_relaxed));
+    }
+    atomic_store_explicit(&node->childCount, count, memory_order_release);
+    return 1;
+}
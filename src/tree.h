@@ -0,0 +1,96 @@
+#ifndef TREE_H
+#define TREE_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "arena.h"
+#include "bitboard.h"
+#include "table.h"
+#include "ttable.h"
+
+/*
+ * Compact search graph for the 3x3 agents. Nodes are named by 32-bit ids
+ * into a table of fixed-size chunks and store no board: the search
+ * rebuilds positions from the moves along its path. A node's children sit
+ * in one block, structure-of-arrays, with the statistics of every edge
+ * side by side so selection reads them in one linear pass.
+ *
+ * Positions reached by different move orders share one node through the
+ * transposition table, so the graph is a DAG: win statistics are kept
+ * per edge, and each node also counts every playout through it.
+ */
+
+typedef uint32_t NodeId;
+
+#define TREE_CHUNK_BITS 8
+#define TREE_CHUNK (1u << TREE_CHUNK_BITS)
+/* A tree holds at most one node per position */
+#define TREE_MAX_CHUNKS ((BB_POSITIONS + TREE_CHUNK - 1) / TREE_CHUNK)
+
+typedef struct {
+    atomic_int visits;     /* Playouts through the position, from any parent */
+    atomic_int childCount; /* Published once the child block is filled */
+    atomic_char expanded;  /* Claimed by the one thread that expands it */
+    atomic_char proven;    /* Winner under perfect play once known, else ' ' (solver.h) */
+    void* block;           /* The children, as treeChildren() lays them out */
+} TreeNode;
+
+/* View of a child block of count edges */
+typedef struct {
+    atomic_int* visits;   /* Playouts through each edge */
+    atomic_int* halfWins; /* Two per win and one per draw for the searching agent */
+    atomic_int* inFlight; /* Virtual losses of playouts still running */
+    NodeId* nodes;
+    unsigned char* moves; /* Cell played */
+    atomic_char* proven;  /* The child's proven value, as last seen from this parent */
+} Children;
+
+typedef struct {
+    Arena* arena;
+    TransTable* table;
+    const Table* solved; /* Positions known before the search, NULL for none */
+    TreeNode* chunks[TREE_MAX_CHUNKS];
+    NodeId count;
+} Tree;
+
+/* An empty tree over storage the caller has reset */
+void treeInit(Tree* tree, Arena* arena, TransTable* table, const Table* solved);
+
+/*
+ * Adds the node for state; its proven value comes from the game or the
+ * table. TT_NONE when the arena is out of memory.
+ */
+NodeId treeAdd(Tree* tree, const BitBoard* state);
+
+/* The node for state, added if the table has none; TT_NONE as treeAdd() */
+NodeId treeFindOrAdd(Tree* tree, const BitBoard* state);
+
+/*
+ * Allocates a zeroed block of count children; publish it by storing
+ * childCount. Out of memory, node->block stays NULL and so does the view.
+ */
+Children treeAllocChildren(Tree* tree, TreeNode* node, int count);
+
+/*
+ * Gives the node at state one child per cell of moves and publishes them.
+ * Returns 0, leaving the node a leaf, when the arena is out of memory.
+ */
+int treeExpand(Tree* tree, TreeNode* node, const BitBoard* state, unsigned moves);
+
+static inline TreeNode* treeNode(const Tree* tree, NodeId id) {
+    return &tree->chunks[id >> TREE_CHUNK_BITS][id & (TREE_CHUNK - 1)];
+}
+
+static inline Children treeChildren(const TreeNode* node, int count) {
+    Children children;
+    char* base = (char*)node->block;
+    children.visits = (atomic_int*)base;
+    children.halfWins = children.visits + count;
+    children.inFlight = children.halfWins + count;
+    children.nodes = (NodeId*)(children.inFlight + count);
+    children.moves = (unsigned char*)(children.nodes + count);
+    children.proven = (atomic_char*)(children.moves + count);
+    return children;
+}
+
+#endif // TREE_H
@@ -0,0 +1,11 @@
+#include <string.h>
+#include "ttable.h"
+
+void ttClear(TransTable* table) {
+    if (++table->stamp == 0) {
+        /* Stamps wrapped around; wipe them so old entries cannot match */
+        memset(table->stamps, 0, sizeof(table->stamps));
+        memset(table->ids, 0, sizeof(table->ids));
+    }
+    table->count = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef TTABLE_H
+#define TTABLE_H
+
+#include "bitboard.h"
+
+/*
+ * Transposition table mapping a position (by bbIndex) to the id of the
+ * search node that holds its statistics. Entries carry the stamp of the
+ * search that stored them, so ttClear() empties the table in O(1). A
+ * zero-initialised table is empty.
+ */
+
+#define TT_NONE 0xFFFFFFFFu
+
+typedef struct {
+    unsigned ids[BB_POSITIONS]; /* Node id + 1, so 0 is never a hit */
+    unsigned stamps[BB_POSITIONS];
+    unsigned stamp;
+    int count;
+} TransTable;
+
+void ttClear(TransTable* table);
+
+/* Returns the node id stored for key, or TT_NONE */
+static inline unsigned ttLookup(const TransTable* table, unsigned key) {
+    return table->stamps[key] == table->stamp ? table->ids[key] - 1 : TT_NONE;
+}
+
+static inline void ttStore(TransTable* table, unsigned key, unsigned id) {
+    if (table->stamps[key] != table->stamp || table->ids[key] == 0)
+        table->count++;
+    table->stamps[key] = table->stamp;
+    table->ids[key] = id + 1;
+}
+
+#endif // TTABLE_H
@@ -0,0 +1,48 @@
+#include <math.h>
+#include <float.h>
+#include <pthread.h>
+#include "ucb.h"
+
+static double logTable[UCB_LOG_TABLE];
+static pthread_once_t tablesOnce = PTHREAD_ONCE_INIT;
+
+static void buildTables(void) {
+    for (int n = 1; n < UCB_LOG_TABLE; n++)
+        logTable[n] = log((double)n);
+}
+
+double ucbLog(int n) {
+    pthread_once(&tablesOnce, buildTables);
+    return n < UCB_LOG_TABLE ? logTable[n] : log((double)n);
+}
+
+int ucbSelectReference(const Children* children, int count, int parentVisits,
+                       double exploration, UcbRule rule) {
+    int best = -1;
+    double bestValue = -DBL_MAX;
+    if (rule == UCB_RULE_A && parentVisits < 1)
+        parentVisits = 1; /* Another thread expanded it but has not backed up yet */
+    for (int i = 0; i < count; i++) {
+        /* Nothing left to learn below a proven child */
+        if (UCB_LOAD(children->proven[i]) != ' ')
+            continue;
+        /* Playouts still running through the child count as losses */
+        int visits = UCB_LOAD(children->visits[i]) + UCB_LOAD(children->inFlight[i]);
+        double value;
+        if (rule == UCB_RULE_A) {
+            /* If the child has not been visited yet, prioritize it */
+            if (visits == 0)
+                return i;
+            double winRate = (double)UCB_LOAD(children->halfWins[i]) / (2.0 * visits);
+            value = winRate + exploration * sqrt(log((double)parentVisits) / (double)visits);
+        } else {
+            double winRate = visits > 0 ? UCB_LOAD(children->halfWins[i]) / (2.0 * visits) : 0.0;
+            value = winRate + exploration * sqrt(log(parentVisits + 1) / (visits + 1));
+        }
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,82 @@
+#ifndef UCB_H
+#define UCB_H
+
+#include <math.h>
+#include <float.h>
+#include "tree.h"
+
+/*
+ * UCB1 selection over a child block (tree.h), by either agent's rule:
+ *   A: unvisited children first, then  w/n + c * sqrt(log(N) / n)
+ *   B: w/n (0 while unvisited)       +  c * sqrt(log(N + 1) / (n + 1))
+ * with n counting virtual losses, N the parent's visits and proven
+ * children skipped. Returns the slot to descend into, or -1 when every
+ * child is proven.
+ *
+ * ucbSelect() is the fast kernel: log(N) from a table of libm's own
+ * results, the children's values in one pass over plain arrays the
+ * compiler can vectorise, and a branch-free argmax. It evaluates the same
+ * expressions in the same order as ucbSelectReference(), the plain loop,
+ * so both pick the same child; the bench cross-checks them.
+ */
+
+typedef enum {
+    UCB_RULE_A, /* Unvisited children first */
+    UCB_RULE_B  /* Smoothed counts */
+} UcbRule;
+
+/* Default exploration constants; SearchConfig.exploration overrides them */
+#define UCB_EXPLORATION_A 0.7
+#define UCB_EXPLORATION_B 1.41
+
+/* log(n) for n >= 1, from the table below UCB_LOG_TABLE */
+#define UCB_LOG_TABLE 4096
+double ucbLog(int n);
+
+int ucbSelectReference(const Children* children, int count, int parentVisits,
+                       double exploration, UcbRule rule);
+
+#define UCB_LOAD(field) atomic_load_explicit(&(field), memory_order_relaxed)
+
+/* Inline so that each caller's constant rule specialises it */
+static inline int ucbSelect(const Children* children, int count, int parentVisits,
+                            double exploration, UcbRule rule) {
+    int visits[BB_CELLS], halfWins[BB_CELLS], open[BB_CELLS];
+    /* Snapshot the shared counters; the passes below run on plain arrays */
+    for (int i = 0; i < count; i++) {
+        visits[i] = UCB_LOAD(children->visits[i]) + UCB_LOAD(children->inFlight[i]);
+        halfWins[i] = UCB_LOAD(children->halfWins[i]);
+        open[i] = UCB_LOAD(children->proven[i]) == ' ';
+    }
+
+    /* Every child's value, with no early exit: unvisited ones (rule A) rank above all, proven ones below */
+    double values[BB_CELLS];
+    if (rule == UCB_RULE_A) {
+        double logParent = ucbLog(parentVisits < 1 ? 1 : parentVisits);
+        for (int i = 0; i < count; i++) {
+            double n = visits[i] > 0 ? visits[i] : 1;
+            double value = halfWins[i] / (2.0 * n) + exploration * sqrt(logParent / n);
+            value = visits[i] == 0 ? HUGE_VAL : value;
+            values[i] = open[i] ? value : -HUGE_VAL;
+        }
+    } else {
+        double logParent = ucbLog(parentVisits + 1);
+        for (int i = 0; i < count; i++) {
+            double winRate = visits[i] > 0 ? halfWins[i] / (2.0 * visits[i]) : 0.0;
+            double value = winRate + exploration * sqrt(logParent / (visits[i] + 1));
+            values[i] = open[i] ? value : -HUGE_VAL;
+        }
+    }
+
+    /* First maximum, as the reference's strict comparison finds it; proven children never win */
+    int best = -1;
+    double bestValue = -DBL_MAX;
+    for (int i = 0; i < count; i++) {
+        int better = values[i] > bestValue;
+        best = better ? i : best;
+        bestValue = better ? values[i] : bestValue;
+    }
+    return best;
+}
+
+#endif // UCB_H
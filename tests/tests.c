@@ -0,0 +1,308 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#include "bitboard.h"
+#include "common.h"
+#include "engine.h"
+#include "rng.h"
+#include "batch.h"
+#include "arena.h"
+#include "tree.h"
+#include "ucb.h"
+#include "policy.h"
+#include "parallel.h"
+#include "tournament.h"
+#include "gamelog.h"
+
+/*
+ * Correctness checks for the fast paths the bench times: each table or
+ * kernel against the plain code it replaces, and the machinery whose
+ * mistakes would not show in a timing. `mcts_tests NAME` runs one check,
+ * with no arguments all of them; CTest runs each as its own test.
+ */
+
+typedef int (*TestFn)(void);
+
+/* The line table against a scan of the eight lines, and against the board-based check */
+static int testWinner(void) {
+    int agree = 1;
+    for (unsigned mask = 0; mask < 512; mask++) {
+        int line = 0;
+        for (int i = 0; i < 8; i++)
+            line |= (mask & bbLines[i]) == bbLines[i];
+        if (bbHasLine(mask) != line) {
+            fprintf(stderr, "bbHasLine(0x%03x) is %d\n", mask, bbHasLine(mask));
+            agree = 0;
+        }
+    }
+    for (unsigned x = 0; x < 512; x++) {
+        for (unsigned o = 0; o < 512; o++) {
+            BitBoard bb = { (unsigned short)x, (unsigned short)o, 'X' };
+            /* The two checks look at the sides in different orders when both have a line */
+            if ((x & o) != 0 || (bbHasLine(x) && bbHasLine(o)))
+                continue;
+            bbToBoard(&bb, board);
+            agree &= bbWinner(&bb) == checkWinner();
+        }
+    }
+    if (!agree)
+        fprintf(stderr, "bbWinner() disagrees with checkWinner()\n");
+    return agree;
+}
+
+/* Agent A's policy table against the heuristic, on every position still in play */
+static int testPolicy(void) {
+    const unsigned char* table = policyTable();
+    int agree = 1;
+    for (unsigned x = 0; x < 512; x++) {
+        for (unsigned o = 0; o < 512; o++) {
+            BitBoard bb = { (unsigned short)x, (unsigned short)o, 'X' };
+            if ((x & o) != 0 || bbIsTerminal(&bb))
+                continue;
+            for (int side = 0; side < 2; side++) {
+                bb.toMove = side == 0 ? 'X' : 'O';
+                if (policyMove(table, &bb) != policyHeuristicMove(&bb))
+                    agree = 0;
+            }
+        }
+    }
+    if (!agree)
+        fprintf(stderr, "policy table disagrees with the heuristic\n");
+    return agree;
+}
+
+/* Every batch kernel the CPU supports, from the same lane seeds, on random positions */
+static int testBatch(void) {
+    static const int kernels[] = { BATCH_SCALAR, BATCH_AVX2 };
+    Rng rng;
+    rngInit(&rng, 42);
+    int agree = 1;
+    for (int p = 0; agree && p < 64; p++) {
+        BitBoard start = { 0, 0, 'X' };
+        int moves = rngBelow(&rng, BB_CELLS);
+        while (moves-- > 0 && !bbIsTerminal(&start)) {
+            unsigned empty = bbEmpty(&start);
+            bbPlay(&start, bbNth(empty, rngBelow(&rng, bbCount(empty))));
+        }
+        if (bbIsTerminal(&start))
+            continue;
+        int reference = -1;
+        for (int k = 0; k < (int)(sizeof(kernels) / sizeof(kernels[0])); k++) {
+            if (!batchAvailable(kernels[k]))
+                continue;
+            BatchRng lanes;
+            batchRngInit(&lanes, (uint64_t)p + 1);
+            int halfWins = batchPlayouts(kernels[k], &start, 1000, &lanes, start.toMove);
+            if (reference < 0)
+                reference = halfWins;
+            else if (halfWins != reference)
+                agree = 0;
+        }
+    }
+    if (!agree)
+        fprintf(stderr, "batch kernels disagree\n");
+    return agree;
+}
+
+/*
+ * The UCB kernel against the reference loop on random child blocks with
+ * ties, unvisited, in-flight and proven children, for both agents' rules
+ * at their default constant and others a sweep might try.
+ */
+static int testUcb(void) {
+    static const UcbRule rules[] = { UCB_RULE_A, UCB_RULE_B };
+    static const double constants[] = { UCB_EXPLORATION_A, UCB_EXPLORATION_B };
+    Arena arena = { 0 };
+    Tree tree;
+    treeInit(&tree, &arena, NULL, NULL);
+    Rng rng;
+    rngInit(&rng, 7);
+
+    int agree = 1;
+    for (int c = 0; c < 4096; c++) {
+        TreeNode node;
+        int count = 1 + rngBelow(&rng, BB_CELLS);
+        Children children = treeAllocChildren(&tree, &node, count);
+        if (node.block == NULL) {
+            agree = 0;
+            break;
+        }
+        int parent = 0;
+        for (int i = 0; i < count; i++) {
+            /* Small counts make exact ties between children common */
+            int visits = rngBelow(&rng, 4) == 0 ? rngBelow(&rng, 3) : rngBelow(&rng, 5000);
+            atomic_init(&children.visits[i], visits);
+            atomic_init(&children.halfWins[i], (int)rngBelow(&rng, 2 * visits + 1));
+            atomic_init(&children.inFlight[i], rngBelow(&rng, 8) == 0 ? (int)rngBelow(&rng, 3) : 0);
+            atomic_init(&children.proven[i], rngBelow(&rng, 8) == 0 ? "XOD"[rngBelow(&rng, 3)] : ' ');
+            parent += visits;
+        }
+        parent += (int)rngBelow(&rng, 3);
+        for (int r = 0; r < 2; r++) {
+            for (int k = 0; k < 3; k++) {
+                double exploration = k == 0 ? constants[r] : k == 1 ? 0.25 : 2.5;
+                if (ucbSelect(&children, count, parent, exploration, rules[r]) !=
+                    ucbSelectReference(&children, count, parent, exploration, rules[r]))
+                    agree = 0;
+            }
+        }
+    }
+    arenaDestroy(&arena);
+    if (!agree)
+        fprintf(stderr, "UCB kernel disagrees with the reference\n");
+    return agree;
+}
+
+#define SCHEDULER_TASKS 100000
+#define SCHEDULER_THREADS 4
+
+/* Work growing with the task number, so the first shares finish early and must steal */
+static void schedulerTask(void* context, int task, int worker) {
+    atomic_int* runs = (atomic_int*)context;
+    volatile int sum = 0;
+    for (int i = 0; i < task % 256; i++)
+        sum += i * worker;
+    atomic_fetch_add(&runs[task], 1);
+}
+
+/* parallelFor() on uneven tasks: each must run exactly once */
+static int testScheduler(void) {
+    atomic_int* runs = (atomic_int*)malloc(SCHEDULER_TASKS * sizeof(atomic_int));
+    if (runs == NULL)
+        return 0;
+    int agree = 1;
+    for (int r = 0; r < 10; r++) {
+        for (int i = 0; i < SCHEDULER_TASKS; i++)
+            atomic_init(&runs[i], 0);
+        parallelFor(schedulerTask, runs, SCHEDULER_TASKS, SCHEDULER_THREADS);
+        for (int i = 0; i < SCHEDULER_TASKS; i++)
+            agree &= atomic_load(&runs[i]) == 1;
+    }
+    free(runs);
+    if (!agree)
+        fprintf(stderr, "parallelFor ran a task other than once\n");
+    return agree;
+}
+
+#define GAMELOG_GAMES 200
+#define GAMELOG_FILE "tests_gamelog.tmp"
+
+/*
+ * A tournament ended by a sequential test, recorded on several threads:
+ * games that finish after the deciding one are still written, so the
+ * log must read back as exactly the games the tournament counted, each
+ * with its winner.
+ */
+static int testGamelog(void) {
+    Sprt sprt;
+    SprtConfig config = { 0 };
+    sprtInit(&sprt, &config);
+    Tournament tournament = { .firstAgent = 'a', .secondAgent = 'c', .numGames = GAMELOG_GAMES,
+                              .jobs = 4, .seed = 5, .sprt = &sprt };
+    GameLogHeader header = { .rows = 3, .cols = 3, .k = 3, .first = 'a', .second = 'c', .seed = 5 };
+    char winners[GAMELOG_GAMES];
+    char seen[GAMELOG_GAMES] = { 0 };
+    if (gamelogOpen(GAMELOG_FILE, &header) != 0)
+        return 0;
+    suppressMessages = 1;
+    int played = runTournament(&tournament, winners);
+    gamelogClose(played);
+
+    int agree = 1, count = 0;
+    GameLog log;
+    if (gamelogMap(&log, GAMELOG_FILE) != 0)
+        agree = 0;
+    GameRecord record;
+    while (agree && gamelogNext(&log, &record)) {
+        int game = (int)record.game;
+        agree = game >= 1 && game <= played && !seen[game - 1] && record.winner == winners[game - 1];
+        if (agree)
+            seen[game - 1] = 1;
+        count++;
+    }
+    agree = agree && count == played;
+    gamelogUnmap(&log);
+    remove(GAMELOG_FILE);
+    if (!agree)
+        fprintf(stderr, "game log does not read back as the %d games counted\n", played);
+    return agree;
+}
+
+/*
+ * Tree reuse across symmetric replies: agent A answers the empty board,
+ * then every reply to its move is searched on the same engine. The tree
+ * expands one reply per set of symmetric ones, so the search after any
+ * of the others must still find its node.
+ */
+static int testReuse(void) {
+    SearchConfig config;
+    memset(&config, 0, sizeof(config));
+    config.iterations = 2000;
+    config.exhaustive = 1;
+    config.threads = 1;
+    config.seed = 1;
+
+    int agree = 1;
+    for (int reply = 0; agree && reply < BB_CELLS; reply++) {
+        GameState state;
+        memset(state.cells, ' ', sizeof(state.cells));
+        state.toMove = 'X';
+        Engine* engine = engineCreate();
+        SearchResult result;
+        engineSearch(engine, 'a', &state, &config, &result);
+        int first = result.row * 3 + result.col;
+        if (reply != first) {
+            state.cells[first / 3][first % 3] = 'X';
+            state.cells[reply / 3][reply % 3] = 'O';
+            engineSearch(engine, 'a', &state, &config, &result);
+            int move = result.row * 3 + result.col;
+            agree = result.reusedVisits > 0 && state.cells[move / 3][move % 3] == ' ';
+            if (!agree)
+                fprintf(stderr, "no tree reused after X at %d, O at %d\n", first, reply);
+        }
+        engineDestroy(engine);
+    }
+    return agree;
+}
+
+static const struct {
+    const char* name;
+    TestFn run;
+} checks[] = {
+    { "winner",    testWinner },
+    { "policy",    testPolicy },
+    { "batch",     testBatch },
+    { "ucb",       testUcb },
+    { "scheduler", testScheduler },
+    { "gamelog",   testGamelog },
+    { "reuse",     testReuse },
+};
+#define NUM_CHECKS (int)(sizeof(checks) / sizeof(checks[0]))
+
+int main(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        int known = 0;
+        for (int c = 0; c < NUM_CHECKS; c++)
+            known |= strcmp(argv[i], checks[c].name) == 0;
+        if (!known) {
+            printf("Usage: %s [check...]\n", argv[0]);
+            printf("Checks: winner policy batch ucb scheduler gamelog reuse (default all)\n");
+            return 1;
+        }
+    }
+
+    int failed = 0;
+    for (int c = 0; c < NUM_CHECKS; c++) {
+        int selected = argc == 1;
+        for (int i = 1; i < argc; i++)
+            selected |= strcmp(argv[i], checks[c].name) == 0;
+        if (!selected)
+            continue;
+        int ok = checks[c].run();
+        printf("%s: %s\n", checks[c].name, ok ? "ok" : "FAILED");
+        failed += !ok;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "common.h"
+#include "gamelog.h"
+#include "mnk.h"
+
+/*
+ * Reads the game records MonteCarlo writes with --record: a summary of
+ * the run by default, the results.dat a plot of it reads, statistics per
+ * 3x3 position reached, or a replay of one game.
+ */
+
+#define DEFAULT_RESULTS "results.dat"
+
+/* Per position reached in play, for --positions */
+typedef struct {
+    unsigned games, xWins, oWins, draws;
+    double visits; /* Summed over the moves played from it */
+} PositionStats;
+
+static PositionStats positions[BB_POSITIONS];
+
+static int is3x3(const GameLogHeader* header) {
+    return header->rows == 3 && header->cols == 3 && header->k == 3;
+}
+
+static void summary(GameLog* log) {
+    const GameLogHeader* header = &log->header;
+    GameRecord record;
+    int games = 0, firstWins = 0, secondWins = 0, draws = 0;
+    long moves = 0;
+    double visits = 0;
+    while (gamelogNext(log, &record)) {
+        games++;
+        moves += record.moves;
+        firstWins += record.winner == 'X';
+        secondWins += record.winner == 'O';
+        draws += record.winner == 'D';
+        for (int i = 0; record.stats && i < record.moves; i++)
+            visits += gamelogStats(&record, i).visits;
+    }
+    printf("Board %dx%d (k = %d), agent %c (X) against agent %c (O), seed %llu\n",
+           header->rows, header->cols, header->k, header->first, header->second,
+           (unsigned long long)header->seed);
+    printf("%d games, %.1f moves on average\n", games, games > 0 ? (double)moves / games : 0.0);
+    printf("Agent %c wins %d, agent %c wins %d, %d draws\n",
+           header->first, firstWins, header->second, secondWins, draws);
+    if (header->flags & GAMELOG_STATS)
+        printf("%.0f root visits per move on average\n", moves > 0 ? visits / moves : 0.0);
+}
+
+static int compareGames(const void* a, const void* b) {
+    const GameRecord* x = (const GameRecord*)a;
+    const GameRecord* y = (const GameRecord*)b;
+    return (x->game > y->game) - (x->game < y->game);
+}
+
+/* Same rows as MonteCarlo writes for the plot, in game order */
+static int writeResults(GameLog* log, const char* path, int excludeDraws) {
+    size_t count = 0, capacity = 1024;
+    GameRecord* records = (GameRecord*)malloc(capacity * sizeof(GameRecord));
+    GameRecord record;
+    while (records != NULL && gamelogNext(log, &record)) {
+        if (count == capacity) {
+            capacity *= 2;
+            GameRecord* grown = (GameRecord*)realloc(records, capacity * sizeof(GameRecord));
+            if (grown == NULL)
+                break;
+            records = grown;
+        }
+        records[count++] = record;
+    }
+    FILE* out = records != NULL ? fopen(path, "w") : NULL;
+    if (out == NULL) {
+        free(records);
+        return -1;
+    }
+    /* Parallel games finish out of order */
+    qsort(records, count, sizeof(GameRecord), compareGames);
+
+    int firstWins = 0, secondWins = 0, draws = 0;
+    for (size_t n = 0; n < count; n++) {
+        int i = (int)n + 1;
+        firstWins += records[n].winner == 'X';
+        secondWins += records[n].winner == 'O';
+        draws += records[n].winner == 'D';
+        int totalGames = excludeDraws ? (firstWins + secondWins) : i;
+        float firstRate = totalGames > 0 ? (float)firstWins / totalGames : 0.0f;
+        float secondRate = totalGames > 0 ? (float)secondWins / totalGames : 0.0f;
+        float drawRate = excludeDraws ? 0.0f : (float)draws / i;
+        fprintf(out, "%d %f %f %f\n", i, firstRate, secondRate, drawRate);
+    }
+    free(records);
+    printf("Wrote %zu games to %s.\n", count, path);
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+static void writePositions(GameLog* log) {
+    GameRecord record;
+    while (gamelogNext(log, &record)) {
+        BitBoard bb = { 0, 0, record.opener };
+        for (int i = 0; i < record.moves; i++) {
+            PositionStats* stats = &positions[bbIndex(&bb)];
+            stats->games++;
+            stats->xWins += record.winner == 'X';
+            stats->oWins += record.winner == 'O';
+            stats->draws += record.winner == 'D';
+            if (record.stats)
+                stats->visits += gamelogStats(&record, i).visits;
+            bbPlay(&bb, record.cells[i]);
+        }
+    }
+    printf("index,board,to_move,games,x_wins,o_wins,draws,mean_visits\n");
+    for (unsigned index = 0; index < BB_POSITIONS; index++) {
+        const PositionStats* stats = &positions[index];
+        if (stats->games == 0)
+            continue;
+        char cells[BB_CELLS + 1];
+        unsigned digits = index % 19683;
+        for (int cell = 0; cell < BB_CELLS; cell++, digits /= 3)
+            cells[cell] = digits % 3 == 1 ? 'X' : digits % 3 == 2 ? 'O' : '.';
+        cells[BB_CELLS] = '\0';
+        printf("%u,%s,%c,%u,%u,%u,%u,%.1f\n", index, cells, index >= 19683 ? 'O' : 'X',
+               stats->games, stats->xWins, stats->oWins, stats->draws, stats->visits / stats->games);
+    }
+}
+
+static void printMnk(const char* cells, int rows, int cols) {
+    printf("\n");
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++)
+            printf(" %c", cells[row * cols + col] == ' ' ? '.' : cells[row * cols + col]);
+        printf("\n");
+    }
+    printf("\n");
+}
+
+static int replay(GameLog* log, int game) {
+    const GameLogHeader* header = &log->header;
+    GameRecord record;
+    int found = 0;
+    while (!found && gamelogNext(log, &record))
+        found = (int)record.game == game;
+    if (!found)
+        return -1;
+
+    int rows = header->rows, cols = header->cols;
+    char cells[MNK_MAX_CELLS];
+    memset(cells, ' ', sizeof(cells));
+    clearScreen = 0;
+    initBoard();
+    char player = record.opener;
+    for (int i = 0; i < record.moves; i++) {
+        int cell = record.cells[i];
+        char agent = player == 'X' ? header->first : header->second;
+        printf("Agent %c (%c) plays row %d, column %d", agent, player, cell / cols, cell % cols);
+        if (record.stats) {
+            GameMoveStats stats = gamelogStats(&record, i);
+            printf(" after %u visits, win rate %.2f%%", stats.visits, stats.winRate * 100.0 / 65535);
+        }
+        printf(".\n");
+        if (is3x3(header)) {
+            board[cell / 3][cell % 3] = player;
+            displayBoard();
+        } else {
+            cells[cell] = player;
+            printMnk(cells, rows, cols);
+        }
+        player = player == 'X' ? 'O' : 'X';
+    }
+    if (record.winner == 'D')
+        printf("Game %d is a draw.\n", game);
+    else
+        printf("Agent %c wins game %d.\n", record.winner == 'X' ? header->first : header->second, game);
+    return 0;
+}
+
+static void usage(const char* program) {
+    printf("Usage: %s LOG [options]\n", program);
+    printf("  (none)              summary of the games in LOG\n");
+    printf("  --results           rebuild the plot data in %s\n", DEFAULT_RESULTS);
+    printf("  -o FILE             --results, written to FILE instead\n");
+    printf("  --exclude-draws     with --results, rates over decided games only\n");
+    printf("  --positions         CSV of every 3x3 position reached, with its outcomes\n");
+    printf("  --replay N          print game N move by move\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* path = NULL;
+    const char* results = NULL;
+    int excludeDraws = 0, listPositions = 0, game = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--results") == 0) {
+            results = DEFAULT_RESULTS;
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            results = argv[++i];
+        } else if (strcmp(argv[i], "--exclude-draws") == 0) {
+            excludeDraws = 1;
+        } else if (strcmp(argv[i], "--positions") == 0) {
+            listPositions = 1;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            game = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && path == NULL) {
+            path = argv[i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (path == NULL) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    GameLog log;
+    if (gamelogMap(&log, path) != 0) {
+        fprintf(stderr, "Error: %s is not a game log\n", path);
+        return 1;
+    }
+    int status = 0;
+    if (results) {
+        if (writeResults(&log, results, excludeDraws) != 0) {
+            fprintf(stderr, "Error: cannot write %s\n", results);
+            status = 1;
+        }
+    } else if (listPositions) {
+        if (is3x3(&log.header)) {
+            writePositions(&log);
+        } else {
+            fprintf(stderr, "Error: --positions only reads 3x3 logs\n");
+            status = 1;
+        }
+    } else if (game > 0) {
+        if (replay(&log, game) != 0) {
+            fprintf(stderr, "Error: %s has no game %d\n", path, game);
+            status = 1;
+        }
+    } else {
+        summary(&log);
+    }
+    gamelogUnmap(&log);
+    return status;
+}
@@ -0,0 +1,193 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "table.h"
+
+/*
+ * Solves tic-tac-toe by exhaustive minimax and writes the table the
+ * agents map with --table: a dense table of every board by default, or a
+ * keyed table of the positions reachable in play, optionally only those
+ * with at most N empty cells (an endgame table for the MCTS agents to
+ * build on).
+ */
+
+#define DEFAULT_OUTPUT "tictactoe.tbl"
+#define MOVE_BYTES 2
+#define KEY_BYTES 2 /* Keys run below 2 * 3^9 */
+
+static char values[BB_POSITIONS];            /* Winner under perfect play, 0 until solved */
+static unsigned short bestMoves[BB_POSITIONS];
+static unsigned char reachable[BB_POSITIONS];
+
+/* 2 for a win for mover, 1 for a draw, 0 for a loss */
+static int rank(char value, char mover) {
+    return (value == mover) ? 2 : (value == 'D') ? 1 : 0;
+}
+
+static char solve(BitBoard bb) {
+    unsigned index = bbIndex(&bb);
+    if (values[index])
+        return values[index];
+    char value = bbWinner(&bb);
+    unsigned moves = 0;
+    if (value == ' ') {
+        char mover = bb.toMove;
+        int best = -1;
+        for (unsigned empty = bbEmpty(&bb); empty; empty &= empty - 1) {
+            int cell = bbFirst(empty);
+            BitBoard child = bb;
+            bbPlay(&child, cell);
+            int score = rank(solve(child), mover);
+            if (score > best) {
+                best = score;
+                moves = BB_BIT(cell);
+            } else if (score == best) {
+                moves |= BB_BIT(cell);
+            }
+        }
+        value = (best == 2) ? mover : (best == 1) ? 'D' : bbOther(mover);
+    }
+    values[index] = value;
+    bestMoves[index] = (unsigned short)moves;
+    return value;
+}
+
+/* Either side may open, so both empty boards are roots */
+static void markReachable(BitBoard bb) {
+    unsigned index = bbIndex(&bb);
+    if (reachable[index])
+        return;
+    reachable[index] = 1;
+    if (bbIsTerminal(&bb))
+        return;
+    for (unsigned empty = bbEmpty(&bb); empty; empty &= empty - 1) {
+        BitBoard child = bb;
+        bbPlay(&child, bbFirst(empty));
+        markReachable(child);
+    }
+}
+
+static BitBoard fromIndex(unsigned index) {
+    BitBoard bb = { 0, 0, index >= 19683 ? 'O' : 'X' };
+    index %= 19683;
+    for (int cell = 0; cell < BB_CELLS; cell++, index /= 3) {
+        if (index % 3 == 1)
+            bb.x |= BB_BIT(cell);
+        else if (index % 3 == 2)
+            bb.o |= BB_BIT(cell);
+    }
+    return bb;
+}
+
+static void digitsOf(const BitBoard* bb, unsigned char digits[BB_CELLS]) {
+    for (int cell = 0; cell < BB_CELLS; cell++)
+        digits[cell] = (bb->x & BB_BIT(cell)) ? 1 : (bb->o & BB_BIT(cell)) ? 2 : 0;
+}
+
+static int included(unsigned index, int keyed, int maxEmpty) {
+    if (!keyed)
+        return 1;
+    BitBoard bb = fromIndex(index);
+    return reachable[index] && bbCount(bbEmpty(&bb)) <= maxEmpty;
+}
+
+static int writeTable(const char* path, int keyed, int maxEmpty, unsigned* written) {
+    FILE* out = fopen(path, "wb");
+    if (out == NULL)
+        return -1;
+    TableHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TABLE_MAGIC, sizeof(header.magic));
+    header.rows = header.cols = header.k = 3;
+    header.keyBytes = keyed ? KEY_BYTES : 0;
+    header.moveBytes = MOVE_BYTES;
+    for (unsigned index = 0; index < BB_POSITIONS; index++)
+        header.count += included(index, keyed, maxEmpty);
+    fwrite(&header, sizeof(header), 1, out);
+
+    /* Ascending indices are ascending big-endian keys */
+    for (unsigned index = 0; index < BB_POSITIONS; index++) {
+        if (!included(index, keyed, maxEmpty))
+            continue;
+        BitBoard bb = fromIndex(index);
+        if (keyed) {
+            unsigned char digits[BB_CELLS], key[KEY_BYTES];
+            digitsOf(&bb, digits);
+            tableKey(digits, BB_CELLS, bb.toMove, key, KEY_BYTES);
+            fwrite(key, 1, KEY_BYTES, out);
+        }
+        unsigned char record[1 + MOVE_BYTES] = {
+            (unsigned char)values[index], (unsigned char)bestMoves[index],
+            (unsigned char)(bestMoves[index] >> 8)
+        };
+        fwrite(record, 1, sizeof(record), out);
+    }
+    *written = header.count;
+    return fclose(out) == 0 ? 0 : -1;
+}
+
+/* Reads the file back through the same code the agents use */
+static int verifyTable(const char* path, int keyed, int maxEmpty) {
+    Table table;
+    if (tableOpen(&table, path) != 0)
+        return -1;
+    int errors = 0;
+    for (unsigned index = 0; index < BB_POSITIONS; index++) {
+        BitBoard bb = fromIndex(index);
+        unsigned moves = 0;
+        char value = tableLookup(&table, &bb, &moves);
+        if (included(index, keyed, maxEmpty))
+            errors += value != values[index] || moves != bestMoves[index];
+        else
+            errors += value != ' ';
+    }
+    tableClose(&table);
+    return errors == 0 ? 0 : -1;
+}
+
+static void usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  -o, --output FILE  where to write the table (default %s)\n", DEFAULT_OUTPUT);
+    printf("  --keyed            only positions reachable in play, keyed and sorted\n");
+    printf("  --max-empty N      keyed, and only positions with at most N empty cells\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* output = DEFAULT_OUTPUT;
+    int keyed = 0, maxEmpty = BB_CELLS;
+    for (int i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-o") == 0 || strcmp(argv[i], "--output") == 0) && i + 1 < argc) {
+            output = argv[++i];
+        } else if (strcmp(argv[i], "--keyed") == 0) {
+            keyed = 1;
+        } else if (strcmp(argv[i], "--max-empty") == 0 && i + 1 < argc) {
+            keyed = 1;
+            maxEmpty = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    for (unsigned index = 0; index < BB_POSITIONS; index++)
+        solve(fromIndex(index));
+    BitBoard start = { 0, 0, 'X' };
+    markReachable(start);
+    start.toMove = 'O';
+    markReachable(start);
+
+    unsigned written = 0;
+    if (writeTable(output, keyed, maxEmpty, &written) != 0) {
+        fprintf(stderr, "Error: cannot write %s\n", output);
+        return 1;
+    }
+    if (verifyTable(output, keyed, maxEmpty) != 0) {
+        fprintf(stderr, "Error: %s does not read back correctly\n", output);
+        return 1;
+    }
+    printf("Wrote %u positions to %s (empty board: %s).\n", written, output,
+           values[0] == 'D' ? "draw" : "decided");
+    return 0;
+}
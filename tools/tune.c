@@ -0,0 +1,379 @@
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "engine.h"
+#include "parallel.h"
+#include "rng.h"
+#include "sprt.h"
+#include "timing.h"
+
+/*
+ * Searches agent settings for the cheapest that are still strong: every
+ * configuration (agent, exploration constant, playouts per move) plays a
+ * match against each reference agent at its defaults. The games run on
+ * all threads through parallelFor(), which keeps them busy although a
+ * 100-playout game is far cheaper than a 5000-playout one. Configurations
+ * whose mean score reaches the target are ranked by search time per move,
+ * the rest by score below them.
+ */
+
+#define MAX_VALUES 32
+#define MAX_CONFIGS 4096
+#define MAX_REFERENCES 4
+
+typedef struct {
+    char agent;         /* 'a' (heuristic rollouts) or 'b' (random rollouts) */
+    double exploration;
+    int iterations;
+} TuneConfig;
+
+/* One game, from the configuration's side */
+typedef struct {
+    char result;        /* 'W', 'D' or 'L' */
+    int moves;
+    int playouts;
+    double searchMs;
+} TuneGame;
+
+typedef struct {
+    const TuneConfig* configs;
+    const char* references;
+    int referenceCount;
+    int games;          /* Per configuration and reference */
+    uint64_t seed;
+    TuneGame* results;  /* One per task */
+    Engine* engines[MAX_SEARCH_THREADS][2]; /* Per worker: configuration, reference */
+} Tune;
+
+/* Totals of a configuration over its matches */
+typedef struct {
+    const TuneConfig* config;
+    int wins[MAX_REFERENCES], draws[MAX_REFERENCES], losses[MAX_REFERENCES];
+    double score;       /* Mean over the references */
+    double msPerMove;
+    double playoutsPerMove;
+    int reached;        /* Score at or above the target */
+} TuneRank;
+
+/* Task (config * references + reference) * games + game */
+static void playTask(void* context, int task, int worker) {
+    Tune* tune = (Tune*)context;
+    int matchup = task / tune->games;
+    const TuneConfig* config = &tune->configs[matchup / tune->referenceCount];
+    char reference = tune->references[matchup % tune->referenceCount];
+    rngSetSeed(tune->seed + (uint64_t)task * 0x9E3779B97F4A7C15ULL);
+    Rng rng;
+    rngInit(&rng, rngStreamSeed());
+
+    /* Separate engines, so neither side inherits a tree the other searched */
+    for (int side = 0; side < 2; side++) {
+        if (tune->engines[worker][side] == NULL)
+            tune->engines[worker][side] = engineCreate();
+        engineNewGame(tune->engines[worker][side]);
+    }
+    SearchConfig search;
+    memset(&search, 0, sizeof(search));
+    search.threads = 1;
+
+    /* The configuration plays X; either side may open */
+    TuneGame* game = &tune->results[task];
+    BitBoard bb = { 0, 0, rngBelow(&rng, 2) == 0 ? 'X' : 'O' };
+    while (bbWinner(&bb) == ' ') {
+        int tuned = bb.toMove == 'X';
+        GameState state;
+        bbToBoard(&bb, state.cells);
+        state.toMove = bb.toMove;
+        search.iterations = tuned ? config->iterations : 0;
+        search.exploration = tuned ? config->exploration : 0;
+        SearchResult result;
+        if (engineSearch(tune->engines[worker][tuned ? 0 : 1], tuned ? config->agent : reference,
+                         &state, &search, &result) != 0)
+            break;
+        if (tuned) {
+            game->moves++;
+            game->playouts += result.iterations;
+            game->searchMs += result.elapsedMs;
+        }
+        bbPlay(&bb, BB_CELL(result.row, result.col));
+    }
+    char winner = bbWinner(&bb);
+    game->result = winner == 'X' ? 'W' : winner == 'O' ? 'L' : 'D';
+}
+
+/* Comma-separated numbers; returns how many were read, or -1 for more than MAX_VALUES */
+static int parseList(const char* text, double* values) {
+    int count = 0;
+    char* end;
+    while (count < MAX_VALUES) {
+        values[count] = strtod(text, &end);
+        if (end == text)
+            break;
+        count++;
+        if (*end != ',')
+            break;
+        text = end + 1;
+    }
+    return count == MAX_VALUES && *end == ',' ? -1 : count;
+}
+
+static void listRange(const double* values, int count, double* low, double* high) {
+    *low = *high = values[0];
+    for (int i = 1; i < count; i++) {
+        *low = values[i] < *low ? values[i] : *low;
+        *high = values[i] > *high ? values[i] : *high;
+    }
+}
+
+/* Every combination of the listed values */
+static int gridConfigs(TuneConfig* configs, const char* agents, const double* explorations,
+                       int explorationCount, const double* iterations, int iterationCount) {
+    int count = 0;
+    for (const char* agent = agents; *agent; agent++)
+        for (int e = 0; e < explorationCount; e++)
+            for (int i = 0; i < iterationCount; i++) {
+                configs[count].agent = *agent;
+                configs[count].exploration = explorations[e];
+                configs[count].iterations = (int)iterations[i];
+                count++;
+            }
+    return count;
+}
+
+/* Configurations drawn between the smallest and largest listed values, playouts on a log scale */
+static int randomConfigs(TuneConfig* configs, int samples, uint64_t seed, const char* agents,
+                         const double* explorations, int explorationCount,
+                         const double* iterations, int iterationCount) {
+    double lowE, highE, lowI, highI;
+    listRange(explorations, explorationCount, &lowE, &highE);
+    listRange(iterations, iterationCount, &lowI, &highI);
+    Rng rng;
+    rngInit(&rng, seed);
+    for (int i = 0; i < samples; i++) {
+        double u = rngNext(&rng) / 4294967296.0, v = rngNext(&rng) / 4294967296.0;
+        configs[i].agent = agents[rngBelow(&rng, (uint32_t)strlen(agents))];
+        configs[i].exploration = lowE + u * (highE - lowE);
+        configs[i].iterations = (int)(lowI * pow(highI / lowI, v) + 0.5);
+    }
+    return samples;
+}
+
+static int compareRanks(const void* a, const void* b) {
+    const TuneRank* x = (const TuneRank*)a;
+    const TuneRank* y = (const TuneRank*)b;
+    if (x->reached != y->reached)
+        return y->reached - x->reached;
+    if (x->reached && x->msPerMove != y->msPerMove)
+        return x->msPerMove < y->msPerMove ? -1 : 1;
+    if (x->score != y->score)
+        return x->score > y->score ? -1 : 1;
+    return x->msPerMove < y->msPerMove ? -1 : x->msPerMove > y->msPerMove;
+}
+
+static void rankConfigs(const Tune* tune, int configCount, double target, TuneRank* ranks) {
+    for (int c = 0; c < configCount; c++) {
+        TuneRank* rank = &ranks[c];
+        memset(rank, 0, sizeof(*rank));
+        rank->config = &tune->configs[c];
+        int moves = 0;
+        double playouts = 0, searchMs = 0;
+        for (int r = 0; r < tune->referenceCount; r++) {
+            for (int g = 0; g < tune->games; g++) {
+                const TuneGame* game = &tune->results[(c * tune->referenceCount + r) * tune->games + g];
+                rank->wins[r] += game->result == 'W';
+                rank->draws[r] += game->result == 'D';
+                rank->losses[r] += game->result == 'L';
+                moves += game->moves;
+                playouts += game->playouts;
+                searchMs += game->searchMs;
+            }
+            rank->score += (rank->wins[r] + 0.5 * rank->draws[r]) / tune->games / tune->referenceCount;
+        }
+        rank->msPerMove = moves > 0 ? searchMs / moves : 0;
+        rank->playoutsPerMove = moves > 0 ? playouts / moves : 0;
+        rank->reached = rank->score >= target;
+    }
+    qsort(ranks, (size_t)configCount, sizeof(TuneRank), compareRanks);
+}
+
+/* Elo over all of a configuration's games, with its 95% interval */
+static void rankElo(const TuneRank* rank, int referenceCount, double* elo, double* low, double* high) {
+    Sprt sprt;
+    memset(&sprt, 0, sizeof(sprt));
+    for (int r = 0; r < referenceCount; r++) {
+        sprt.wins += rank->wins[r];
+        sprt.draws += rank->draws[r];
+        sprt.losses += rank->losses[r];
+    }
+    sprtElo(&sprt, elo, low, high);
+}
+
+static void report(const TuneRank* ranks, int count, const Tune* tune, int csv) {
+    if (csv) {
+        printf("rank,agent,exploration,iterations,ms_per_move,playouts_per_move");
+        for (int r = 0; r < tune->referenceCount; r++)
+            printf(",score_%c", tune->references[r]);
+        printf(",score,elo,elo_low,elo_high,reaches_target\n");
+    } else {
+        printf("%4s %5s %6s %9s %8s", "rank", "agent", "ucb", "playouts", "ms/move");
+        for (int r = 0; r < tune->referenceCount; r++)
+            printf("   vs %c", tune->references[r]);
+        printf("  score  elo (95%%)\n");
+    }
+    for (int i = 0; i < count; i++) {
+        const TuneRank* rank = &ranks[i];
+        double elo, low, high;
+        rankElo(rank, tune->referenceCount, &elo, &low, &high);
+        if (csv)
+            printf("%d,%c,%.4f,%d,%.4f,%.1f", i + 1, rank->config->agent, rank->config->exploration,
+                   rank->config->iterations, rank->msPerMove, rank->playoutsPerMove);
+        else
+            printf("%3d%c %5c %6.3f %9d %8.3f", i + 1, rank->reached ? '*' : ' ', rank->config->agent,
+                   rank->config->exploration, rank->config->iterations, rank->msPerMove);
+        for (int r = 0; r < tune->referenceCount; r++) {
+            double score = (rank->wins[r] + 0.5 * rank->draws[r]) / tune->games;
+            printf(csv ? ",%.4f" : " %6.3f", score);
+        }
+        if (csv)
+            printf(",%.4f,%.1f,%.1f,%.1f,%d\n", rank->score, elo, low, high, rank->reached);
+        else
+            printf(" %6.3f  %+.0f (%+.0f, %+.0f)\n", rank->score, elo, low, high);
+    }
+}
+
+static void usage(const char* program) {
+    printf("Usage: %s [options]\n", program);
+    printf("  --agents LIST        agents to tune: a (heuristic rollouts), b (random) (default ab)\n");
+    printf("  --ucb LIST           exploration constants, comma-separated (default 0.35,0.7,1.41)\n");
+    printf("  --iterations LIST    playouts per move (default 100,300,1000,3000)\n");
+    printf("  --random N           N configurations drawn between the smallest and largest\n");
+    printf("                       listed values instead of the full grid\n");
+    printf("  --against LIST       reference agents, at their defaults (default ca)\n");
+    printf("  --games N            games per configuration and reference (default 50)\n");
+    printf("  --target S           mean score that counts as strong enough (default 0.7)\n");
+    printf("  -j, --jobs N         threads playing games (default: one per CPU)\n");
+    printf("  -s, --seed N         seed for the games and the random search (default 1)\n");
+    printf("  --format text|csv    ranking as a table or CSV (default text)\n");
+}
+
+int main(int argc, char* argv[]) {
+    const char* agents = "ab";
+    const char* references = "ca";
+    double explorations[MAX_VALUES] = { 0.35, 0.7, 1.41 };
+    double iterations[MAX_VALUES] = { 100, 300, 1000, 3000 };
+    int explorationCount = 3, iterationCount = 4;
+    int samples = 0, games = 50, jobs = parallelCpuCount(), csv = 0;
+    double target = 0.7;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--agents") == 0 && i + 1 < argc) {
+            agents = argv[++i];
+        } else if (strcmp(argv[i], "--ucb") == 0 && i + 1 < argc) {
+            explorationCount = parseList(argv[++i], explorations);
+        } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterationCount = parseList(argv[++i], iterations);
+        } else if (strcmp(argv[i], "--random") == 0 && i + 1 < argc) {
+            samples = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--against") == 0 && i + 1 < argc) {
+            references = argv[++i];
+        } else if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+            games = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc) {
+            target = atof(argv[++i]);
+        } else if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--jobs") == 0) && i + 1 < argc) {
+            jobs = atoi(argv[++i]);
+            if (jobs <= 0)
+                jobs = parallelCpuCount();
+        } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--seed") == 0) && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            i++;
+            if (strcmp(argv[i], "csv") == 0) {
+                csv = 1;
+            } else if (strcmp(argv[i], "text") == 0) {
+                csv = 0;
+            } else {
+                usage(argv[0]);
+                return 1;
+            }
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    int referenceCount = (int)strlen(references);
+    if (strspn(agents, "ab") != strlen(agents) || agents[0] == '\0' ||
+        strspn(references, "abc") != (size_t)referenceCount ||
+        referenceCount == 0 || referenceCount > MAX_REFERENCES) {
+        fprintf(stderr, "Error: agents are a or b, references up to %d of a, b and c\n", MAX_REFERENCES);
+        return 1;
+    }
+    if (explorationCount < 0 || iterationCount < 0) {
+        fprintf(stderr, "Error: at most %d values per list\n", MAX_VALUES);
+        return 1;
+    }
+    if (explorationCount == 0 || iterationCount == 0 || games <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    for (int i = 0; i < iterationCount; i++) {
+        if (iterations[i] < 1) {
+            fprintf(stderr, "Error: playouts per move must be positive\n");
+            return 1;
+        }
+    }
+
+    /* Refused rather than cut short, which would rank part of the space as if it were all of it */
+    long long requested = samples > 0 ? samples : (long long)strlen(agents) * explorationCount * iterationCount;
+    if (requested > MAX_CONFIGS) {
+        fprintf(stderr, "Error: %lld configurations; at most %d fit in one run\n", requested, MAX_CONFIGS);
+        return 1;
+    }
+    if (requested * referenceCount * games > INT_MAX) {
+        fprintf(stderr, "Error: %lld games; at most %d fit in one run\n",
+                requested * referenceCount * games, INT_MAX);
+        return 1;
+    }
+
+    static TuneConfig configs[MAX_CONFIGS];
+    int configCount = samples > 0 ?
+        randomConfigs(configs, samples, seed, agents, explorations, explorationCount, iterations, iterationCount) :
+        gridConfigs(configs, agents, explorations, explorationCount, iterations, iterationCount);
+    int tasks = configCount * referenceCount * games;
+
+    Tune tune;
+    memset(&tune, 0, sizeof(tune));
+    tune.configs = configs;
+    tune.references = references;
+    tune.referenceCount = referenceCount;
+    tune.games = games;
+    tune.seed = seed;
+    tune.results = (TuneGame*)calloc((size_t)tasks, sizeof(TuneGame));
+    TuneRank* ranks = (TuneRank*)malloc((size_t)configCount * sizeof(TuneRank));
+    if (tune.results == NULL || ranks == NULL) {
+        fprintf(stderr, "Error: out of memory for %d games\n", tasks);
+        return 1;
+    }
+
+    jobs = parallelThreads(jobs);
+    fprintf(stderr, "%d configurations x %d references x %d games on %d threads\n",
+            configCount, referenceCount, games, jobs);
+    double start = timeNowMs();
+    parallelFor(playTask, &tune, tasks, jobs);
+    fprintf(stderr, "Played %d games in %.1f s\n", tasks, (timeNowMs() - start) / 1000);
+
+    rankConfigs(&tune, configCount, target, ranks);
+    report(ranks, configCount, &tune, csv);
+
+    for (int w = 0; w < MAX_SEARCH_THREADS; w++) {
+        engineDestroy(tune.engines[w][0]);
+        engineDestroy(tune.engines[w][1]);
+    }
+    free(ranks);
+    free(tune.results);
+    return 0;
+}